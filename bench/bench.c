@@ -0,0 +1,100 @@
+#include "bench.h"
+
+/* ==========================================================================
+**  Benchmarks — point d'entrée et environnement commun
+**  --------------------------------------------------------------------------
+**  bench_game_init : jeu complet sans MLX (carte, joueur, textures, écran
+**                    en mémoire, pool, cible de rendu, scheduler, tables)
+**  main            : ./poke3d_bench <suite> [options]
+** ========================================================================== */
+
+void    bench_game_init(t_game *g, int w, int h)
+{
+    __builtin_memset(g, 0, sizeof(*g));
+    config_defaults(g);
+    g->be = &g_backend_mem;
+    setup_map_small(g);
+    setup_player(g, 2, 2, 0.0f);
+    g->tex_wall.layout = TEX_COL_MAJOR;
+    /* Textures synthétiques (damier bruité) en mémoire */
+    if (!tex_procedural(&g->tex_wall, 64, 64, 1)
+        || !tex_procedural(&g->tex_sky, 1024, 256, 2)
+        || !tex_procedural(&g->tex_floor, 64, 64, 3)
+        || !tex_sprite_procedural(&tex_pokeball, 64))
+        panic("bench: textures");
+    sprite_runs_build(&pokeball_runs, &tex_pokeball);
+
+    /* Écran en mémoire (backend sans affichage), même format qu'une image MLX */
+    if (!create_frame(g, w, h)) panic("bench: create_frame");
+
+    if (!pool_init(&g->pool, render_thread_count())) panic("bench: pool_init");
+    dda_select(g);
+    transpose_select(g);
+    g->fb_mode = fb_mode_from_env();
+    /* Cible de rendu = écran (100 %); les suites peuvent appeler rt_resize
+       ou game_resize pour changer de taille en cours de route */
+    drs_init(g);
+    PROF_INIT(g);   /* make PROFILE=1: temps par étape (+ POKE3D_PERF) */
+    if (!rt_fit(g)) panic("bench: rt_resize");
+    view_update(g);
+}
+
+void    bench_game_free(t_game *g)
+{
+    PROF_FREE(g);
+    pool_destroy(&g->pool);
+    sched_destroy(&g->sched);
+    render_free(g);
+    destroy_frame(g);
+    destroy_tex(g, &g->tex_wall);
+    destroy_tex(g, &g->tex_sky);
+    destroy_tex(g, &g->tex_floor);
+    destroy_tex(g, &tex_pokeball);
+    sprite_runs_free(&pokeball_runs);
+    map_free(g);
+}
+
+typedef struct s_suite
+{
+    const char  *name;
+    int         (*run)(int argc, char **argv);
+    const char  *help;
+}   t_suite;
+
+static const t_suite g_suites[] = {
+    { "verify", bench_verify, "test différentiel: impacts de chaque DDA vs scalaire" },
+    { "dda", bench_dda, "traversée des rayons seule, par traverseur et par carte" },
+    { "floor", bench_floor, "floor casting: ancien per-colonne vs lignes" },
+    { "fb", bench_fb, "framebuffer direct vs transposé (720p, 1080p, 4K)" },
+    { "drs", bench_drs, "résolution dynamique: rendu + agrandissement par palier" },
+    { "res", bench_res, "balayage de résolutions (game_resize) dans un seul run" },
+    { "sprites", bench_sprites, "Pokéballs: coût selon le nombre (0 à 5000)" },
+    { "mapfile", bench_mapfile, "chargement de carte: mmap + 2 passes, 1000² à 10000²" },
+    { "world", bench_world, "monde en chunks: marche, disque lent, préchargement, cache" },
+    { "paths", bench_paths, "trajets de caméra scriptés: moyenne, p50/p95/p99, JSON" },
+    { NULL, NULL, NULL }
+};
+
+int     main(int argc, char **argv)
+{
+    int i;
+
+    if (argc >= 2)
+    {
+        i = 0;
+        while (g_suites[i].name)
+        {
+            if (!strcmp(argv[1], g_suites[i].name))
+                return (g_suites[i].run(argc - 1, argv + 1));
+            i++;
+        }
+    }
+    fprintf(stderr, "usage: %s <suite> [options]\n", argv[0]);
+    i = 0;
+    while (g_suites[i].name)
+    {
+        fprintf(stderr, "  %-10s %s\n", g_suites[i].name, g_suites[i].help);
+        i++;
+    }
+    return (2);
+}
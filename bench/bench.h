@@ -0,0 +1,32 @@
+#ifndef BENCH_H
+#define BENCH_H
+
+/* =============================
+**  POKE3D — Benchmarks
+**  Petit binaire séparé (make bench) qui réutilise le moteur sans fenêtre:
+**  framebuffer en mémoire, textures synthétiques, même pipeline de rendu.
+**  Chaque suite est une fonction bench_xxx(argc, argv) choisie par nom.
+** ============================= */
+
+# include "game.h"
+# include <stdio.h>
+
+/* Nombre de frames mesurées par défaut et frames de chauffe ignorées. */
+# define BENCH_FRAMES  200
+# define BENCH_WARMUP  10
+
+void        bench_game_init(t_game *g, int w, int h);
+void        bench_game_free(t_game *g);
+
+int         bench_dda(int argc, char **argv);
+int         bench_floor(int argc, char **argv);
+int         bench_fb(int argc, char **argv);
+int         bench_drs(int argc, char **argv);
+int         bench_res(int argc, char **argv);
+int         bench_paths(int argc, char **argv);
+int         bench_sprites(int argc, char **argv);
+int         bench_verify(int argc, char **argv);
+int         bench_mapfile(int argc, char **argv);
+int         bench_world(int argc, char **argv);
+
+#endif
@@ -0,0 +1,306 @@
+#include "bench.h"
+
+/* ==========================================================================
+**  Bench "dda" — traversée des rayons seule (stage_hits)
+**  --------------------------------------------------------------------------
+**  Pour chaque traverseur disponible (scalar, sse4, avx2) et chaque carte,
+**  la caméra fait un tour complet; on ne mesure que la passe des impacts
+**  (un rayon par colonne), en rayons par seconde et en cases visitées par
+**  rayon (somme des pas en X et en Y, déduite des impacts).
+**    - small : la carte du jeu (rayons courts)
+**    - open  : salle DDA_MAP × DDA_MAP, piliers tous les 16 cases
+**              (rayons longs: le coût par pas domine)
+**
+**  Puis les sauts d'espace vide (champ de distance de dfield.c, pyramide
+**  d'occupation de mip.c) avec le traverseur par défaut, sur des cartes
+**  de 64² à 8192² cases:
+**    - open : bord seul (rayons de la demi-carte, sauts jusqu'à DF_MAX
+**             pour le champ, blocs de toute taille pour la pyramide)
+**    - maze : pièces 3×3 reliées par des portes (murs toutes les 4 cases)
+**  Mrays/s sans saut, avec le champ, avec la pyramide; temps de
+**  construction du champ et de la pyramide; puis DF_EDITS cases basculées
+**  mur <-> vide par map_set_cell: temps moyen d'une mise à jour locale
+**  (les deux structures), comparées à une reconstruction complète.
+**
+**  Usage: poke3d_bench dda [frames] [largeur] [hauteur]
+** ========================================================================== */
+
+#define DDA_MAP 256
+
+#define DF_EDITS 200
+
+static const char   *g_dda_names[] = { "scalar", "sse4", "avx2", NULL };
+static const int    g_df_sizes[] = { 64, 256, 1024, 4096, 8192, 0 };
+
+static void open_room(t_game *g)
+{
+    static char     cells[DDA_MAP][DDA_MAP + 1];
+    const char      *rows[DDA_MAP + 1];
+    int             x;
+    int             y;
+
+    y = 0;
+    while (y < DDA_MAP)
+    {
+        x = 0;
+        while (x < DDA_MAP)
+        {
+            cells[y][x] = (x == 0 || y == 0 || x == DDA_MAP - 1 || y == DDA_MAP - 1
+                           || (x % 16 == 8 && y % 16 == 8)) ? '1' : '0';
+            x++;
+        }
+        cells[y][DDA_MAP] = '\0';
+        rows[y] = cells[y];
+        y++;
+    }
+    rows[DDA_MAP] = NULL;
+    map_load_rows(g, rows);
+}
+
+/* Cases visitées par le rayon de la colonne x (pas en X + pas en Y) */
+static long long    ray_cells(const t_game *g, int x)
+{
+    int dx = g->hits.map_x[x] - (int)g->view.pos.x;
+    int dy = g->hits.map_y[x] - (int)g->view.pos.y;
+
+    return ((dx < 0 ? -dx : dx) + (dy < 0 ? -dy : dy));
+}
+
+static void time_dda(t_game *g, float cx, float cy, int frames, double *mrays,
+                     double *cells)
+{
+    long long   total;
+    long long   steps;
+    long long   t0;
+    int         i;
+    int         x;
+
+    total = 0;
+    steps = 0;
+    i = -BENCH_WARMUP;
+    while (i < frames)
+    {
+        setup_player(g, 0, 0, 360.0f * ((i < 0) ? 0 : i) / frames);
+        g->p.pos.x = cx;
+        g->p.pos.y = cy;
+        view_update(g);
+        t0 = clock_ns();
+        render_pass(g, stage_hits);
+        if (i >= 0)
+        {
+            total += clock_ns() - t0;
+            x = 0;
+            while (x < g->view.w)
+                steps += ray_cells(g, x++);
+        }
+        i++;
+    }
+    *mrays = (total > 0) ? (double)g->view.w * frames / (total / 1e3) : 0.0;
+    *cells = (double)steps / ((double)g->view.w * frames);
+}
+
+/* Carte n × n: bord seul (maze = 0) ou pièces 3×3 avec portes */
+static void df_map(t_game *g, int n, int maze)
+{
+    char        *buf;
+    const char  **rows;
+    int         x;
+    int         y;
+
+    buf = (char *)malloc((size_t)n * (n + 1));
+    rows = (const char **)malloc(sizeof(char *) * (n + 1));
+    if (!buf || !rows)
+        panic("bench: malloc map");
+    y = 0;
+    while (y < n)
+    {
+        x = 0;
+        while (x < n)
+        {
+            buf[(size_t)y * (n + 1) + x] = (x == 0 || y == 0 || x == n - 1 || y == n - 1
+                || (maze && ((x % 4 == 0 && y % 4 != 2) || (y % 4 == 0 && x % 4 != 2))))
+                ? '1' : '0';
+            x++;
+        }
+        buf[(size_t)y * (n + 1) + n] = '\0';
+        rows[y] = buf + (size_t)y * (n + 1);
+        y++;
+    }
+    rows[n] = NULL;
+    map_load_rows(g, rows);
+    free(rows);
+    free(buf);
+}
+
+/* Champ et niveaux de la pyramide copiés bout à bout (size = NULL: taille
+   seule), pour comparer le résultat des mises à jour locales */
+static size_t   skip_copy(const t_grid *gr, int h, unsigned char *out)
+{
+    size_t  n;
+    size_t  k;
+    int     l;
+
+    n = (size_t)gr->stride * (h + 2);
+    if (out)
+        __builtin_memcpy(out, gr->field, n);
+    l = 1;
+    while (l <= gr->mip_levels)
+    {
+        k = (size_t)gr->mip_w[l] * gr->mip_h[l];
+        if (out)
+            __builtin_memcpy(out + n, gr->mip[l], k);
+        n += k;
+        l++;
+    }
+    return (n);
+}
+
+/* DF_EDITS cases intérieures basculées (graine fixe), la moitié remises:
+   µs par mise à jour, et 1 si champ et pyramide égalent une reconstruction
+   complète (temps de chacune dans build_ms[0] et build_ms[1]) */
+static int  df_edits(t_game *g, double *us, double *build_ms)
+{
+    const size_t    size = skip_copy(&g->grid, g->map_h, NULL);
+    unsigned char   *copy;
+    unsigned char   *full;
+    unsigned int    seed;
+    long long       t0;
+    long long       total;
+    int             same;
+    int             x[DF_EDITS];
+    int             y[DF_EDITS];
+    int             i;
+
+    seed = 4242;
+    total = 0;
+    i = 0;
+    while (i < DF_EDITS)
+    {
+        seed = seed * 1103515245u + 12345u;
+        x[i] = 1 + (int)((seed >> 8) % (g->map_w - 2));
+        seed = seed * 1103515245u + 12345u;
+        y[i] = 1 + (int)((seed >> 8) % (g->map_h - 2));
+        t0 = clock_ns();
+        map_set_cell(g, x[i], y[i], GRID_SOLID(&g->grid, x[i], y[i]) ? '0' : '1');
+        total += clock_ns() - t0;
+        i++;
+    }
+    i = 0;
+    while (i < DF_EDITS / 2)
+    {
+        t0 = clock_ns();
+        map_set_cell(g, x[i], y[i], GRID_SOLID(&g->grid, x[i], y[i]) ? '0' : '1');
+        total += clock_ns() - t0;
+        i++;
+    }
+    *us = total / 1e3 / (DF_EDITS + DF_EDITS / 2);
+    copy = (unsigned char *)malloc(size);
+    full = (unsigned char *)malloc(size);
+    if (!copy || !full)
+        panic("bench: malloc copy");
+    skip_copy(&g->grid, g->map_h, copy);
+    t0 = clock_ns();
+    df_build(&g->grid, g->map_w, g->map_h);
+    build_ms[0] = (clock_ns() - t0) / 1e6;
+    t0 = clock_ns();
+    if (!mip_build(&g->grid, g->map_h))
+        panic("bench: mip_build");
+    build_ms[1] = (clock_ns() - t0) / 1e6;
+    skip_copy(&g->grid, g->map_h, full);
+    same = !__builtin_memcmp(copy, full, size);
+    free(copy);
+    free(full);
+    return (same);
+}
+
+static void bench_skip(t_game *g, int frames)
+{
+    double  mrays[3];
+    double  cells;
+    double  us;
+    double  build[2];
+    int     same;
+    int     maze;
+    int     i;
+    int     k;
+    int     f;
+    float   c;
+
+    printf("empty-space skipping, dda %s, %d rays per frame (Mrays/s)\n",
+           g->dda_name, g->frame.w);
+    printf("  %-5s %6s %10s %8s %8s %8s %9s %9s %10s %6s\n", "map", "size",
+           "cells/ray", "none", "field", "mip", "field ms", "mip ms", "update us", "exact");
+    maze = 0;
+    while (maze < 2)
+    {
+        i = 0;
+        while (g_df_sizes[i])
+        {
+            df_map(g, g_df_sizes[i], maze);
+            /* Pièce (maze) ou centre (open) */
+            c = g_df_sizes[i] / 2 + (maze ? 1.5f : 0.5f);
+            f = (g_df_sizes[i] >= 4096) ? (frames + 3) / 4 : frames;
+            k = DDA_SKIP_NONE;
+            while (k <= DDA_SKIP_MIP)
+            {
+                g->dda_skip = k;
+                time_dda(g, c, c, f, &mrays[k], &cells);
+                k++;
+            }
+            same = df_edits(g, &us, build);
+            printf("  %-5s %6d %10.1f %8.2f %8.2f %8.2f %9.1f %9.1f %10.2f %6s\n",
+                   maze ? "maze" : "open", g_df_sizes[i], cells, mrays[0], mrays[1],
+                   mrays[2], build[0], build[1], us, same ? "yes" : "NO");
+            i++;
+        }
+        maze++;
+    }
+}
+
+int     bench_dda(int argc, char **argv)
+{
+    t_game      g;
+    int         frames = (argc > 1) ? atoi(argv[1]) : BENCH_FRAMES;
+    int         w = (argc > 2) ? atoi(argv[2]) : WIN_W;
+    int         h = (argc > 3) ? atoi(argv[3]) : WIN_H;
+    double      mrays;
+    double      cells;
+    int         m;
+    int         d;
+
+    if (frames < 1) frames = 1;
+    bench_game_init(&g, w, h);
+    printf("dda, %d rays per frame, %d frames (360° spin)\n", g.frame.w, frames);
+    printf("  %-6s %-7s %12s %12s\n", "map", "dda", "Mrays/s", "cells/ray");
+    m = 0;
+    while (m < 2)
+    {
+        if (m == 0)
+            setup_map_small(&g);
+        else
+            open_room(&g);
+        d = 0;
+        while (g_dda_names[d])
+        {
+            setenv("POKE3D_DDA", g_dda_names[d], 1);
+            dda_select(&g);
+            if (!strcmp(g.dda_name, g_dda_names[d]))
+            {
+                if (m == 0)
+                    time_dda(&g, 17.5f, 6.5f, frames, &mrays, &cells);
+                else
+                    time_dda(&g, DDA_MAP / 2 + 0.5f, DDA_MAP / 2 + 0.5f, frames,
+                             &mrays, &cells);
+                printf("  %-6s %-7s %12.1f %12.1f\n", m ? "open" : "small",
+                       g.dda_name, mrays, cells);
+            }
+            d++;
+        }
+        m++;
+    }
+    unsetenv("POKE3D_DDA");
+    dda_select(&g);
+    bench_skip(&g, frames / 5 > 0 ? frames / 5 : 1);
+    bench_game_free(&g);
+    return (0);
+}
@@ -0,0 +1,61 @@
+#include "bench.h"
+
+/* ==========================================================================
+**  Bench "drs" — coût d'une frame à chaque palier de résolution
+**  --------------------------------------------------------------------------
+**  Pour chaque palier de DRS_LEVELS: rendu dans la cible réduite puis
+**  agrandissement dans l'écran, même suite de caméras. Le gouverneur est
+**  désactivé (paliers forcés via rt_resize).
+**
+**  Usage: poke3d_bench drs [frames] [largeur] [hauteur]
+** ========================================================================== */
+
+static const int    g_pct[] = DRS_LEVELS;
+
+int     bench_drs(int argc, char **argv)
+{
+    t_game      g;
+    int         frames = (argc > 1) ? atoi(argv[1]) : BENCH_FRAMES / 2;
+    int         w = (argc > 2) ? atoi(argv[2]) : WIN_W;
+    int         h = (argc > 3) ? atoi(argv[3]) : WIN_H;
+    long long   render;
+    long long   up;
+    long long   t0;
+    int         l;
+    int         i;
+
+    if (frames < 1) frames = 1;
+    bench_game_init(&g, w, h);
+    g.drs.last.target_ms = 0.0;
+    printf("dynamic resolution, %dx%d screen, %d frames, upscale %s\n",
+           w, h, frames, drs_stats(&g)->upscale);
+    printf("  %5s %11s %12s %12s %12s\n", "scale", "target", "render ms", "upscale ms", "total ms");
+    l = 0;
+    while (l < (int)(sizeof(g_pct) / sizeof(g_pct[0])))
+    {
+        if (!rt_resize(&g, w * g_pct[l] / 100, h * g_pct[l] / 100))
+            panic("bench: rt_resize");
+        render = 0;
+        up = 0;
+        i = -BENCH_WARMUP;
+        while (i < frames)
+        {
+            setup_player(&g, 2 + ((i + BENCH_WARMUP) % 24), 5, (float)(i * 7 % 360));
+            t0 = clock_ns();
+            render_scene(&g);
+            if (i >= 0)
+                render += clock_ns() - t0;
+            t0 = clock_ns();
+            rt_upscale(&g);
+            if (i >= 0)
+                up += clock_ns() - t0;
+            i++;
+        }
+        printf("  %4d%% %5dx%-5d %12.3f %12.3f %12.3f\n", g_pct[l], g.frame.w,
+               g.frame.h, render / 1e6 / frames, up / 1e6 / frames,
+               (render + up) / 1e6 / frames);
+        l++;
+    }
+    bench_game_free(&g);
+    return (0);
+}
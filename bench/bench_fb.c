@@ -0,0 +1,93 @@
+#include "bench.h"
+
+/* ==========================================================================
+**  Bench "fb" — framebuffer direct vs transposé
+**  --------------------------------------------------------------------------
+**  Pour 720p, 1080p et 4K, et pour chaque mode de framebuffer:
+**    - "walls" : la partie qui diffère entre les modes (écriture des bandes
+**                de mur, + transposition par blocs en mode transposé)
+**    - "frame" : la scène complète (render_scene, sans l'affichage MLX)
+**
+**  Usage: poke3d_bench fb [frames]
+** ========================================================================== */
+
+typedef struct s_res
+{
+    int         w;
+    int         h;
+    const char  *name;
+}   t_res;
+
+static const t_res  g_res[] = {
+    { 1280, 720, "720p" },
+    { 1920, 1080, "1080p" },
+    { 3840, 2160, "4K" },
+    { 0, 0, NULL }
+};
+
+static void camera_at(t_game *g, int i)
+{
+    /* Caméra proche des murs (bandes hautes) puis plus loin: même suite pour
+       tous; i commence à -BENCH_WARMUP */
+    i += BENCH_WARMUP;
+    setup_player(g, 1 + (i % 30), 1 + (i % 7), (float)(i * 11 % 360));
+}
+
+static void time_mode(t_game *g, int mode, int frames, double *walls_ms, double *frame_ms)
+{
+    long long   walls = 0;
+    long long   total = 0;
+    long long   t0;
+    int         i;
+
+    g->fb_mode = mode;
+    i = -BENCH_WARMUP;
+    while (i < frames)
+    {
+        camera_at(g, i);
+        view_update(g);
+        render_pass(g, stage_hits);
+        t0 = clock_ns();
+        if (mode == FB_TRANSPOSED && colfb_ensure(g))
+        {
+            render_pass(g, stage_walls);
+            render_pass(g, stage_transpose);
+        }
+        else
+            render_pass(g, stage_walls);
+        if (i >= 0)
+            walls += clock_ns() - t0;
+        t0 = clock_ns();
+        render_scene(g);
+        if (i >= 0)
+            total += clock_ns() - t0;
+        i++;
+    }
+    *walls_ms = walls / 1e6 / frames;
+    *frame_ms = total / 1e6 / frames;
+}
+
+int     bench_fb(int argc, char **argv)
+{
+    t_game  g;
+    int     frames = (argc > 1) ? atoi(argv[1]) : BENCH_FRAMES / 2;
+    double  dw, df, tw, tf;
+    int     r;
+
+    if (frames < 1) frames = 1;
+    printf("framebuffer modes, %d frames\n", frames);
+    printf("  %-6s %-12s %12s %12s\n", "res", "mode", "walls ms", "frame ms");
+    r = 0;
+    while (g_res[r].name)
+    {
+        bench_game_init(&g, g_res[r].w, g_res[r].h);
+        time_mode(&g, FB_DIRECT, frames, &dw, &df);
+        time_mode(&g, FB_TRANSPOSED, frames, &tw, &tf);
+        printf("  %-6s %-12s %12.3f %12.3f\n", g_res[r].name, "direct", dw, df);
+        printf("  %-6s %-12s %12.3f %12.3f   (%s, walls %.2fx, frame %.2fx)\n",
+               g_res[r].name, "transposed", tw, tf, g.tr_name, dw / tw, df / tf);
+        bench_game_free(&g);
+        r++;
+    }
+    return (0);
+}
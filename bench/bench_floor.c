@@ -0,0 +1,112 @@
+#include "bench.h"
+
+/* ==========================================================================
+**  Bench "floor" — floor casting avant / après
+**  --------------------------------------------------------------------------
+**  floor_legacy : l'ancienne boucle par colonne, qui recalculait rowDist,
+**                 dir0/dir1, floorX_left et l'ombrage pour CHAQUE pixel
+**                 (texel_at avec modulo + clamp, put_pixel borné)
+**  bench_floor  : mesure la passe seule, sur un thread, pour les deux
+**                 versions et la même suite de caméras
+**
+**  Usage: poke3d_bench floor [frames] [largeur] [hauteur]
+** ========================================================================== */
+
+static int  legacy_texel(t_tex *t, int u, int v)
+{
+    u %= t->w;
+    if (u < 0) u += t->w;
+    if (v < 0) v = 0;
+    if (v > t->h - 1) v = t->h - 1;
+    return (*(int *)(t->addr + (v * t->line_len + u * (t->bpp / 8))));
+}
+
+static void floor_legacy(t_game *g, int x0, int x1)
+{
+    const t_view    *v = &g->view;
+    int             x;
+
+    x = x0;
+    while (x < x1)
+    {
+        float dir0x = v->dir.x - v->plane.x;
+        float dir0y = v->dir.y - v->plane.y;
+        float dir1x = v->dir.x + v->plane.x;
+        float dir1y = v->dir.y + v->plane.y;
+        float posZ = 0.5f * (float)v->h;
+        int   y = g->hits.draw_end[x] + 1;
+
+        while (y < v->h)
+        {
+            float p = (float)y - (float)v->h / 2.0f;
+            if (p == 0.0f) p = 0.0001f;
+            float rowDist = posZ / p;
+            float floorX_left  = v->pos.x + rowDist * dir0x;
+            float floorY_left  = v->pos.y + rowDist * dir0y;
+            float floorX = floorX_left + (rowDist * (dir1x - dir0x)) * ((float)x / (float)v->w);
+            float floorY = floorY_left + (rowDist * (dir1y - dir0y)) * ((float)x / (float)v->w);
+            float fx = floorX - floorf(floorX);
+            float fy = floorY - floorf(floorY);
+            int   color = legacy_texel(&g->tex_floor, (int)(fx * (float)g->tex_floor.w),
+                                       (int)(fy * (float)g->tex_floor.h));
+            float shade = 1.0f / (1.0f + 0.02f * rowDist * rowDist);
+            put_pixel(&g->frame, x, y, rgb((int)(((color >> 16) & 255) * shade),
+                                           (int)(((color >> 8) & 255) * shade),
+                                           (int)((color & 255) * shade)));
+            y++;
+        }
+        x++;
+    }
+}
+
+static void floor_scanline(t_game *g, int x0, int x1)
+{
+    floor_rows_update(g);
+    stage_floor(g, x0, x1);
+}
+
+static double   time_floor(t_game *g, void (*fn)(t_game *, int, int), int frames)
+{
+    long long   total = 0;
+    long long   t0;
+    int         i;
+
+    i = -BENCH_WARMUP;
+    while (i < frames)
+    {
+        /* Caméra qui tourne et avance: même séquence pour les deux versions */
+        setup_player(g, 2 + (i & 15), 5, (float)(i * 7 % 360));
+        view_update(g);
+        render_pass(g, stage_hits);
+        t0 = clock_ns();
+        fn(g, 0, g->view.w);
+        if (i >= 0)
+            total += clock_ns() - t0;
+        i++;
+    }
+    return (total / 1e6 / frames);
+}
+
+int     bench_floor(int argc, char **argv)
+{
+    t_game  g;
+    int     frames = (argc > 1) ? atoi(argv[1]) : BENCH_FRAMES;
+    int     w = (argc > 2) ? atoi(argv[2]) : WIN_W;
+    int     h = (argc > 3) ? atoi(argv[3]) : WIN_H;
+    double  before;
+    double  after;
+    double  mpix;
+
+    if (frames < 1) frames = 1;
+    bench_game_init(&g, w, h);
+    before = time_floor(&g, floor_legacy, frames);
+    after = time_floor(&g, floor_scanline, frames);
+    /* Pixels de sol ~ moitié basse de l'écran */
+    mpix = (double)w * (h / 2) / 1e6;
+    printf("floor %dx%d, %d frames, 1 thread\n", w, h, frames);
+    printf("  legacy (per-column)  %8.3f ms/frame  %8.1f Mpix/s\n", before, mpix / (before / 1e3));
+    printf("  scanline (per-row)   %8.3f ms/frame  %8.1f Mpix/s\n", after, mpix / (after / 1e3));
+    printf("  speedup              %8.2fx\n", before / after);
+    bench_game_free(&g);
+    return (0);
+}
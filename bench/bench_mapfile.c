@@ -0,0 +1,183 @@
+#include "bench.h"
+
+/* ==========================================================================
+**  Suite "mapfile" — chargement d'une carte depuis un fichier (map_file.c)
+**  --------------------------------------------------------------------------
+**  Cartes n × n écrites dans /tmp (graine fixe): bord plein, 20 % de murs,
+**  une Pokéball pour mille cases, un départ 'P' au centre; lignes de
+**  longueurs inégales (fin de ligne pleine) et une sur deux en "\r\n".
+**  Pour chaque taille, meilleur de [runs] chargements par map_load_file:
+**    - scan   : passe de validation (dimensions, 'C', départs)
+**    - fill   : grille allouée et remplie, sprites posés
+**    - MB/s   : octets du fichier / (scan + fill)
+**    - derive : champ de distance, pyramide, index des sprites (dfield.c,
+**               mip.c, sprite_grid.c)
+**  Puis le même contenu passé à map_load_rows (tableau de chaînes): temps
+**  de référence, et plan solid + sprites comparés octet par octet ("same").
+**
+**  Usage: poke3d_bench mapfile [runs] [côté max]
+** ========================================================================== */
+
+static const int    g_mapfile_sizes[] = { 1000, 4000, 10000, 0 };
+
+/* Contenu de la carte n × n: rows pointe dans text ("\r" ou "\n" remplacé
+   par '\0' pour map_load_rows); renvoie la taille du fichier */
+static size_t   mapfile_text(int n, char *text, const char **rows)
+{
+    unsigned int    seed;
+    size_t          k;
+    int             len;
+    int             x;
+    int             y;
+
+    seed = 99;
+    k = 0;
+    y = 0;
+    while (y < n)
+    {
+        rows[y] = text + k;
+        len = (y % 7 == 3) ? n - 1 - y % 5 : n;
+        x = 0;
+        while (x < len)
+        {
+            seed = seed * 1103515245u + 12345u;
+            if (x == n / 2 && y == n / 2)
+                text[k++] = 'P';
+            else if (x == 0 || y == 0 || x == n - 1 || y == n - 1
+                     || (seed >> 8) % 100 < 20)
+                text[k++] = '1';
+            else
+            {
+                seed = seed * 1103515245u + 12345u;
+                text[k++] = ((seed >> 8) % 1000 == 0) ? 'C' : '0';
+            }
+            x++;
+        }
+        if (y % 2)
+            text[k++] = '\r';
+        text[k++] = '\n';
+        y++;
+    }
+    rows[n] = NULL;
+    return (k);
+}
+
+static void mapfile_write(const char *path, const char *text, size_t n)
+{
+    FILE    *f;
+
+    f = fopen(path, "wb");
+    if (!f || fwrite(text, 1, n, f) != n || fclose(f) != 0)
+        panic("mapfile: cannot write map");
+}
+
+/* Fins de ligne coupées: text devient le tableau de chaînes de rows */
+static void mapfile_cut(char *text, size_t n)
+{
+    size_t  k;
+
+    k = 0;
+    while (k < n)
+    {
+        if (text[k] == '\r' || text[k] == '\n')
+            text[k] = '\0';
+        k++;
+    }
+}
+
+/* Plan solid et sprites (x, y, active: pas le remplissage de t_sprite) de
+   la carte courante, bout à bout, pour comparer les deux chargeurs */
+static unsigned char    *mapfile_copy(const t_game *g, size_t *n)
+{
+    const size_t    plane = (size_t)g->grid.stride * (g->map_h + 2);
+    const size_t    one = 2 * sizeof(float) + 1;
+    unsigned char   *out;
+    unsigned char   *p;
+    int             i;
+
+    *n = plane + one * sprite_count;
+    out = (unsigned char *)malloc(*n);
+    if (!out)
+        panic("mapfile: malloc copy");
+    __builtin_memcpy(out, g->grid.solid, plane);
+    p = out + plane;
+    i = 0;
+    while (i < sprite_count)
+    {
+        __builtin_memcpy(p, &sprites[i].x, sizeof(float));
+        __builtin_memcpy(p + sizeof(float), &sprites[i].y, sizeof(float));
+        p[2 * sizeof(float)] = sprites[i].active;
+        p += one;
+        i++;
+    }
+    return (out);
+}
+
+static void mapfile_size(t_game *g, int n, int runs)
+{
+    char            path[64];
+    char            *text;
+    const char      **rows;
+    unsigned char   *ref;
+    unsigned char   *got;
+    t_map_stats     st;
+    t_map_stats     best;
+    size_t          bytes;
+    size_t          nref;
+    size_t          ngot;
+    long long       t0;
+    int             r;
+
+    text = (char *)malloc((size_t)n * (n + 2));
+    rows = (const char **)malloc(sizeof(char *) * (n + 1));
+    if (!text || !rows)
+        panic("mapfile: malloc text");
+    bytes = mapfile_text(n, text, rows);
+    snprintf(path, sizeof(path), "/tmp/poke3d_map_%d.ber", n);
+    mapfile_write(path, text, bytes);
+    best.scan_ns = 0;
+    r = 0;
+    while (r < runs)
+    {
+        if (!map_load_file(g, path, &st))
+            panic("mapfile: map_load_file failed");
+        if (r == 0 || st.scan_ns + st.fill_ns < best.scan_ns + best.fill_ns)
+            best = st;
+        r++;
+    }
+    got = mapfile_copy(g, &ngot);
+    mapfile_cut(text, bytes);
+    t0 = clock_ns();
+    map_load_rows(g, rows);
+    t0 = clock_ns() - t0;
+    ref = mapfile_copy(g, &nref);
+    printf("  %6d %8.1f %9.1f %9.1f %9.0f %10.1f %9.1f %8d %6s\n", n, best.bytes / 1e6,
+           best.scan_ns / 1e6, best.fill_ns / 1e6,
+           best.bytes / 1e3 / ((best.scan_ns + best.fill_ns) / 1e6),
+           best.derive_ns / 1e6, t0 / 1e6, sprite_count,
+           (nref == ngot && !__builtin_memcmp(ref, got, nref)) ? "yes" : "NO");
+    free(ref);
+    free(got);
+    free(rows);
+    free(text);
+    remove(path);
+}
+
+int     bench_mapfile(int argc, char **argv)
+{
+    t_game  g;
+    int     runs = (argc > 1) ? atoi(argv[1]) : 3;
+    int     max = (argc > 2) ? atoi(argv[2]) : 10000;
+    int     i;
+
+    if (runs < 1) runs = 1;
+    bench_game_init(&g, 64, 64);
+    printf("mapfile, map_load_file (mmap, 2 passes) vs map_load_rows, best of %d\n", runs);
+    printf("  %6s %8s %9s %9s %9s %10s %9s %8s %6s\n", "size", "MB", "scan ms",
+           "fill ms", "MB/s", "derive ms", "rows ms", "sprites", "same");
+    i = 0;
+    while (g_mapfile_sizes[i] && g_mapfile_sizes[i] <= max)
+        mapfile_size(&g, g_mapfile_sizes[i++], runs);
+    bench_game_free(&g);
+    return (0);
+}
@@ -0,0 +1,337 @@
+#include "bench.h"
+
+/* ==========================================================================
+**  Bench "paths" — trajets de caméra scriptés, percentiles par frame
+**  --------------------------------------------------------------------------
+**  Chaque carte fournit quatre trajets déterministes (interpolation
+**  linéaire entre une pose de départ et une pose d'arrivée):
+**    - corridor : marche droit dans l'axe d'un long couloir
+**    - spin     : tour complet sur place (360°)
+**    - wallhug  : longe un mur à 0.2 case en le regardant de biais
+**                 (colonnes de mur hautes sur tout l'écran)
+**    - field    : traverse une zone ouverte en balayant le regard
+**                 (rayons longs, beaucoup de sol et de ciel)
+**  Chaque trajet est rejoué à chaque résolution; chaque frame passe par
+**  render_frame (rendu + agrandissement + present du backend mémoire),
+**  gouverneur DRS désactivé. Rapport: moyenne, p50, p95, p99 du temps de
+**  frame et rayons par seconde (un rayon par colonne de la cible).
+**
+**  Build profileur (make PROFILE=1) + POKE3D_PERF=1: IPC et défauts de
+**  cache / branche par pixel, sommés sur le trajet, s'ajoutent au JSON.
+**
+**  Usage: poke3d_bench paths [frames] [fichier.json]
+** ========================================================================== */
+
+/* Pose de départ (x0, y0, a0) et d'arrivée (x1, y1, a1), angles en degrés */
+typedef struct s_path
+{
+    const char  *name;
+    float       x0, y0, a0;
+    float       x1, y1, a1;
+}   t_path;
+
+#define PATH_COUNT 4
+
+typedef struct s_bmap
+{
+    const char          *name;
+    const char *const   *rows;      /* NULL: la carte du jeu (setup_map_small) */
+    t_path              paths[PATH_COUNT];
+}   t_bmap;
+
+typedef struct s_result
+{
+    const char  *map;
+    const char  *path;
+    int         w;
+    int         h;
+    double      mean_ms;
+    double      p50_ms;
+    double      p95_ms;
+    double      p99_ms;
+    double      rays_per_s;
+    long long   pmu[PMU_COUNT]; /* compteurs sommés sur le trajet (-1 = absents) */
+    long long   pixels;
+}   t_result;
+
+/* Couloirs en serpentin d'une case de large */
+static const char *const g_maze[] = {
+    "1111111111111111111111111111111111111111",
+    "1000000000000000000000000000000000000001",
+    "1111111111111111111111111111111111111101",
+    "1000000000000000000000000000000000000001",
+    "1011111111111111111111111111111111111111",
+    "1000000000000000000000000000000000000001",
+    "1111111111111111111111111111111111111101",
+    "1000000000000000000000000000000000000001",
+    "1111111111111111111111111111111111111111",
+    NULL
+};
+
+/* Grande salle ouverte, piliers tous les 8 cases */
+static const char *const g_arena[] = {
+    "11111111111111111111111111111111",
+    "10000000000000000000000000000001",
+    "10000000000000000000000000000001",
+    "10000000000000000000000000000001",
+    "10001000000010000000100000001001",
+    "10000000000000000000000000000001",
+    "10000000000000000000000000000001",
+    "10000000000000000000000000000001",
+    "10000000000000000000000000000001",
+    "10000000000000000000000000000001",
+    "10000000000000000000000000000001",
+    "10000000000000000000000000000001",
+    "10001000000010000000100000001001",
+    "10000000000000000000000000000001",
+    "10000000000000000000000000000001",
+    "10000000000000000000000000000001",
+    "10000000000000000000000000000001",
+    "10000000000000000000000000000001",
+    "10000000000000000000000000000001",
+    "10000000000000000000000000000001",
+    "10001000000010000000100000001001",
+    "10000000000000000000000000000001",
+    "10000000000000000000000000000001",
+    "10000000000000000000000000000001",
+    "10000000000000000000000000000001",
+    "10000000000000000000000000000001",
+    "10000000000000000000000000000001",
+    "10000000000000000000000000000001",
+    "10001000000010000000100000001001",
+    "10000000000000000000000000000001",
+    "10000000000000000000000000000001",
+    "11111111111111111111111111111111",
+    NULL
+};
+
+static const t_bmap g_maps[] = {
+    { "small", NULL, {
+        { "corridor", 1.5f, 5.5f, 0.0f, 31.5f, 5.5f, 0.0f },
+        { "spin", 17.0f, 6.0f, 0.0f, 17.0f, 6.0f, 360.0f },
+        { "wallhug", 2.0f, 1.2f, -35.0f, 31.0f, 1.2f, -35.0f },
+        { "field", 12.0f, 11.0f, -37.0f, 31.0f, 2.0f, 3.0f } } },
+    { "maze", g_maze, {
+        { "corridor", 1.5f, 3.5f, 0.0f, 38.5f, 3.5f, 0.0f },
+        { "spin", 20.5f, 5.5f, 0.0f, 20.5f, 5.5f, 360.0f },
+        { "wallhug", 2.0f, 1.2f, -35.0f, 37.0f, 1.2f, -35.0f },
+        { "field", 38.5f, 7.5f, 170.0f, 1.5f, 7.5f, 190.0f } } },
+    { "arena", g_arena, {
+        { "corridor", 1.5f, 8.5f, 0.0f, 30.5f, 8.5f, 0.0f },
+        { "spin", 16.0f, 16.0f, 0.0f, 16.0f, 16.0f, 360.0f },
+        { "wallhug", 2.0f, 1.2f, -35.0f, 30.0f, 1.2f, -35.0f },
+        { "field", 2.5f, 16.5f, -25.0f, 29.5f, 16.5f, 25.0f } } },
+    { NULL, NULL, { { NULL, 0, 0, 0, 0, 0, 0 } } }
+};
+
+static const int    g_sizes[][2] = { { 640, 360 }, { 1280, 720 }, { 1920, 1080 } };
+
+/* Pose de la frame i sur n: position et angle interpolés, plan caméra
+   recalculé pour le FOV courant */
+static void path_pose(t_game *g, const t_path *p, int i, int n)
+{
+    float   t = (n > 1) ? (float)i / (float)(n - 1) : 0.0f;
+    float   a = (p->a0 + (p->a1 - p->a0) * t) * (float)M_PI / 180.0f;
+
+    g->p.pos.x = p->x0 + (p->x1 - p->x0) * t;
+    g->p.pos.y = p->y0 + (p->y1 - p->y0) * t;
+    g->p.dir.x = cosf(a);
+    g->p.dir.y = sinf(a);
+    game_set_fov(g, g->fov);
+}
+
+static int  cmp_ll(const void *a, const void *b)
+{
+    long long   x = *(const long long *)a;
+    long long   y = *(const long long *)b;
+
+    return ((x > y) - (x < y));
+}
+
+/* Percentile au rang le plus proche sur un tableau trié */
+static double   pct_ms(const long long *sorted, int n, int pct)
+{
+    int k = (n * pct + 99) / 100 - 1;
+
+    if (k < 0) k = 0;
+    if (k >= n) k = n - 1;
+    return (sorted[k] / 1e6);
+}
+
+/* Compteurs matériels de la frame qui vient d'être rendue (toutes étapes) */
+static void pmu_accumulate(const t_game *g, t_result *r)
+{
+#ifdef POKE3D_PROFILE
+    const t_prof_frame  *f = prof_last(g);
+    int                 s;
+    int                 e;
+
+    if (!f)
+        return ;
+    r->pixels += f->pixels;
+    e = 0;
+    while (e < PMU_COUNT)
+    {
+        s = 0;
+        while (r->pmu[e] >= 0 && s < PROF_COUNT)
+        {
+            if (f->pmu[s][e] < 0)
+                r->pmu[e] = -1;
+            else
+                r->pmu[e] += f->pmu[s][e];
+            s++;
+        }
+        e++;
+    }
+#else
+    (void)g;
+    __builtin_memset(r->pmu, -1, sizeof(r->pmu));
+#endif
+}
+
+static void run_path(t_game *g, const t_path *p, int frames, long long *ns, t_result *r)
+{
+    long long   total;
+    long long   t0;
+    int         i;
+
+    __builtin_memset(r->pmu, 0, sizeof(r->pmu));
+    r->pixels = 0;
+    /* Chauffe sur la pose de départ, puis le trajet complet mesuré */
+    i = -BENCH_WARMUP;
+    while (i < frames)
+    {
+        path_pose(g, p, (i < 0) ? 0 : i, frames);
+        t0 = clock_ns();
+        render_frame(g);
+        if (i >= 0)
+            ns[i] = clock_ns() - t0;
+        if (i >= 0)
+            pmu_accumulate(g, r);
+        i++;
+    }
+    total = 0;
+    i = 0;
+    while (i < frames)
+        total += ns[i++];
+    qsort(ns, frames, sizeof(*ns), cmp_ll);
+    r->path = p->name;
+    r->w = g->screen.w;
+    r->h = g->screen.h;
+    r->mean_ms = total / 1e6 / frames;
+    r->p50_ms = pct_ms(ns, frames, 50);
+    r->p95_ms = pct_ms(ns, frames, 95);
+    r->p99_ms = pct_ms(ns, frames, 99);
+    r->rays_per_s = (total > 0) ? (double)g->frame.w * frames / (total / 1e9) : 0.0;
+}
+
+/* Champs des compteurs matériels, seulement s'ils ont été mesurés */
+static void write_json_pmu(FILE *f, const t_result *r)
+{
+    static const char   *names[PMU_COUNT] = {
+        NULL, NULL, "l1d_miss_per_px", "llc_miss_per_px", "br_miss_per_px"
+    };
+    int                 e;
+
+    if (r->pmu[PMU_CYCLES] <= 0 || r->pixels <= 0)
+        return ;
+    if (r->pmu[PMU_INSTR] >= 0)
+        fprintf(f, ", \"ipc\": %.3f", (double)r->pmu[PMU_INSTR] / r->pmu[PMU_CYCLES]);
+    e = PMU_L1D_MISS;
+    while (e < PMU_COUNT)
+    {
+        if (r->pmu[e] >= 0)
+            fprintf(f, ", \"%s\": %.5f", names[e], (double)r->pmu[e] / r->pixels);
+        e++;
+    }
+}
+
+static void write_json(FILE *f, const t_game *g, int frames, const t_result *r, int n)
+{
+    int i;
+
+    fprintf(f, "{\n  \"suite\": \"paths\",\n  \"frames\": %d,\n  \"warmup\": %d,\n"
+            "  \"threads\": %d,\n  \"dda\": \"%s\",\n  \"fb\": \"%s\",\n"
+            "  \"fov\": %.1f,\n  \"results\": [\n", frames, BENCH_WARMUP,
+            g->pool.count, g->dda_name,
+            g->fb_mode == FB_TRANSPOSED ? "transposed" : "direct", g->fov);
+    i = 0;
+    while (i < n)
+    {
+        fprintf(f, "    { \"map\": \"%s\", \"path\": \"%s\", \"width\": %d, "
+                "\"height\": %d, \"mean_ms\": %.4f, \"p50_ms\": %.4f, "
+                "\"p95_ms\": %.4f, \"p99_ms\": %.4f, \"rays_per_s\": %.0f",
+                r[i].map, r[i].path, r[i].w, r[i].h, r[i].mean_ms, r[i].p50_ms,
+                r[i].p95_ms, r[i].p99_ms, r[i].rays_per_s);
+        write_json_pmu(f, &r[i]);
+        fprintf(f, " }%s\n", (i + 1 < n) ? "," : "");
+        i++;
+    }
+    fprintf(f, "  ]\n}\n");
+}
+
+int     bench_paths(int argc, char **argv)
+{
+    static t_result     res[(sizeof(g_maps) / sizeof(g_maps[0]) - 1)
+                            * PATH_COUNT * (sizeof(g_sizes) / sizeof(g_sizes[0]))];
+    t_game              g;
+    int                 frames = (argc > 1) ? atoi(argv[1]) : BENCH_FRAMES / 4;
+    const char          *json = (argc > 2) ? argv[2] : NULL;
+    long long           *ns;
+    FILE                *f;
+    int                 n;
+    int                 m;
+    int                 s;
+    int                 p;
+
+    if (frames < 1) frames = 1;
+    ns = (long long *)malloc(sizeof(*ns) * frames);
+    if (!ns) panic("bench: malloc");
+    bench_game_init(&g, g_sizes[0][0], g_sizes[0][1]);
+    g.drs.last.target_ms = 0.0;
+    printf("camera paths, %d frames per path, %d threads, dda %s\n",
+           frames, g.pool.count, g.dda_name);
+    printf("  %-6s %-9s %-10s %9s %9s %9s %9s %12s\n", "map", "path", "size",
+           "mean ms", "p50 ms", "p95 ms", "p99 ms", "Mrays/s");
+    n = 0;
+    m = 0;
+    while (g_maps[m].name)
+    {
+        if (g_maps[m].rows)
+            map_load_rows(&g, g_maps[m].rows);
+        else
+            setup_map_small(&g);
+        s = 0;
+        while (s < (int)(sizeof(g_sizes) / sizeof(g_sizes[0])))
+        {
+            if (!game_resize(&g, g_sizes[s][0], g_sizes[s][1]))
+                panic("bench: game_resize");
+            p = 0;
+            while (p < PATH_COUNT)
+            {
+                res[n].map = g_maps[m].name;
+                run_path(&g, &g_maps[m].paths[p], frames, ns, &res[n]);
+                printf("  %-6s %-9s %4dx%-5d %9.3f %9.3f %9.3f %9.3f %12.2f\n",
+                       res[n].map, res[n].path, res[n].w, res[n].h, res[n].mean_ms,
+                       res[n].p50_ms, res[n].p95_ms, res[n].p99_ms,
+                       res[n].rays_per_s / 1e6);
+                n++;
+                p++;
+            }
+            s++;
+        }
+        m++;
+    }
+    if (json)
+    {
+        f = fopen(json, "w");
+        if (!f)
+            panic("bench: cannot open json output");
+        write_json(f, &g, frames, res, n);
+        fclose(f);
+        printf("wrote %s\n", json);
+    }
+    free(ns);
+    bench_game_free(&g);
+    return (0);
+}
@@ -0,0 +1,54 @@
+#include "bench.h"
+
+/* ==========================================================================
+**  Bench "res" — balayage de résolutions dans un seul processus
+**  --------------------------------------------------------------------------
+**  Un seul jeu initialisé; game_resize passe d'un préréglage de
+**  RES_PRESETS au suivant (écran, cible, scheduler et tables refaits),
+**  puis la même suite de caméras est mesurée. Le FOV est optionnel.
+**
+**  Usage: poke3d_bench res [frames] [fov]
+** ========================================================================== */
+
+int     bench_res(int argc, char **argv)
+{
+    static const int    presets[][2] = RES_PRESETS;
+    t_game              g;
+    int                 frames = (argc > 1) ? atoi(argv[1]) : BENCH_FRAMES / 2;
+    long long           total;
+    long long           t0;
+    int                 r;
+    int                 i;
+
+    if (frames < 1) frames = 1;
+    bench_game_init(&g, WIN_W, WIN_H);
+    if (argc > 2)
+        g.fov = (float)atof(argv[2]);
+    g.drs.last.target_ms = 0.0;
+    printf("resolution sweep, fov %.1f, %d frames\n", g.fov, frames);
+    printf("  %-11s %10s %12s\n", "size", "ms/frame", "ns/pixel");
+    r = 0;
+    while (r < (int)(sizeof(presets) / sizeof(presets[0])))
+    {
+        if (!game_resize(&g, presets[r][0], presets[r][1]))
+            panic("bench: game_resize");
+        total = 0;
+        i = -BENCH_WARMUP;
+        while (i < frames)
+        {
+            setup_player(&g, 2 + ((i + BENCH_WARMUP) % 24), 5, (float)(i * 7 % 360));
+            t0 = clock_ns();
+            render_scene(&g);
+            rt_upscale(&g);
+            if (i >= 0)
+                total += clock_ns() - t0;
+            i++;
+        }
+        printf("  %5dx%-5d %10.3f %12.3f\n", g.screen.w, g.screen.h,
+               total / 1e6 / frames,
+               (double)total / frames / ((double)g.screen.w * g.screen.h));
+        r++;
+    }
+    bench_game_free(&g);
+    return (0);
+}
@@ -0,0 +1,299 @@
+#include "bench.h"
+
+/* ==========================================================================
+**  Bench "sprites" — coût des Pokéballs selon leur nombre
+**  --------------------------------------------------------------------------
+**  Une grande salle ouverte (SPR_MAP × SPR_MAP, piliers réguliers) où N
+**  cases tirées au hasard (graine fixe) portent une Pokéball. La caméra
+**  fait un tour complet au centre; on mesure la frame complète, la part
+**  projection + tri + dessin des sprites, et le nombre moyen de visibles,
+**  puis à part la sélection/projection (sprites_project) et le test de
+**  ramassage (sprite_pickup), tous deux servis par l'index par case.
+**  Une dernière ligne refait le tour au centre d'une carte de SPR_BIG²
+**  cases (piliers, une Pokéball pour mille cases, environ 100 000): le
+**  coût de la requête doit y dépendre de la portée de la vue, pas de la
+**  taille de la carte.
+**
+**  Puis, avec l'asset pokeball.xpm (1024², clé "None"), la passe des
+**  sprites seule en SPRITE_KEYED (test de clé par texel) et SPRITE_RUNS
+**  (segments opaques): tour complet avec 100 et 1000 Pokéballs, et une
+**  Pokéball de face à 0.6, 1.5 et 4 cases. Les deux modes doivent donner
+**  la même image (somme de contrôle de la frame).
+**
+**  Usage: poke3d_bench sprites [frames] [largeur] [hauteur]
+** ========================================================================== */
+
+#define SPR_MAP 96
+#define SPR_BIG 10000
+
+static const int    g_counts[] = { 0, 10, 100, 1000, 5000 };
+
+/* Salle SPR_MAP², piliers tous les 8 cases, n Pokéballs */
+static void arena_with_sprites(t_game *g, int n)
+{
+    static char     cells[SPR_MAP][SPR_MAP + 1];
+    const char      *rows[SPR_MAP + 1];
+    unsigned int    seed;
+    int             x;
+    int             y;
+
+    y = 0;
+    while (y < SPR_MAP)
+    {
+        x = 0;
+        while (x < SPR_MAP)
+        {
+            cells[y][x] = (x == 0 || y == 0 || x == SPR_MAP - 1 || y == SPR_MAP - 1
+                           || (x % 8 == 4 && y % 8 == 4)) ? '1' : '0';
+            x++;
+        }
+        cells[y][SPR_MAP] = '\0';
+        rows[y] = cells[y];
+        y++;
+    }
+    rows[SPR_MAP] = NULL;
+    seed = 12345;
+    while (n > 0)
+    {
+        seed = seed * 1103515245u + 12345u;
+        x = 1 + (int)((seed >> 8) % (SPR_MAP - 2));
+        seed = seed * 1103515245u + 12345u;
+        y = 1 + (int)((seed >> 8) % (SPR_MAP - 2));
+        /* Pas de Pokéball sous la caméra (elle serait ramassée/trop proche) */
+        if (cells[y][x] == '0' && (x < SPR_MAP / 2 - 1 || x > SPR_MAP / 2 + 1))
+        {
+            cells[y][x] = 'C';
+            n--;
+        }
+    }
+    map_load_rows(g, rows);
+}
+
+/* Carte side², piliers tous les 8 cases, une Pokéball pour mille cases
+   libres (graine fixe) hors du voisinage du centre */
+static void big_with_sprites(t_game *g, int side)
+{
+    char            *text;
+    const char      **rows;
+    unsigned int    seed;
+    size_t          k;
+    int             x;
+    int             y;
+
+    text = (char *)malloc((size_t)side * (side + 1));
+    rows = (const char **)malloc(sizeof(char *) * (side + 1));
+    if (!text || !rows)
+        panic("sprites: malloc big map");
+    seed = 777;
+    k = 0;
+    y = 0;
+    while (y < side)
+    {
+        rows[y] = text + k;
+        x = 0;
+        while (x < side)
+        {
+            seed = seed * 1103515245u + 12345u;
+            if (x == 0 || y == 0 || x == side - 1 || y == side - 1
+                || (x % 8 == 4 && y % 8 == 4))
+                text[k++] = '1';
+            else if ((seed >> 8) % 1000 == 0 && abs(x - side / 2) > 1)
+                text[k++] = 'C';
+            else
+                text[k++] = '0';
+            x++;
+        }
+        text[k++] = '\0';
+        y++;
+    }
+    rows[side] = NULL;
+    map_load_rows(g, rows);
+    free(rows);
+    free(text);
+}
+
+/* Une seule Pokéball, de face, à la distance d du joueur */
+static void single_ball(t_game *g, float d)
+{
+    static const char   *rows[] = {
+        "1111111111111111", "1000000000000001", "1000000000000001",
+        "1000000000000001", "10000000000000C1", "1000000000000001",
+        "1000000000000001", "1000000000000001", "1111111111111111", NULL };
+
+    map_load_rows(g, rows);
+    setup_player(g, 0, 4, 0.0f);
+    g->p.pos.x = 14.5f - d;
+    g->p.pos.y = 4.5f;
+    view_update(g);
+}
+
+static unsigned long long   frame_sum(const t_img *img)
+{
+    unsigned long long  h;
+    int                 x;
+    int                 y;
+
+    h = 1469598103934665603ull;
+    y = 0;
+    while (y < img->h)
+    {
+        x = 0;
+        while (x < img->w)
+            h = (h ^ img->rows[y][(size_t)x++ * img->xstep]) * 1099511628211ull;
+        y++;
+    }
+    return (h);
+}
+
+/* Passe des sprites seule (ms/frame) dans le mode donné; *sum = somme de
+   contrôle de la première frame mesurée rendue en entier */
+static double   time_blit(t_game *g, int mode, int spin, int frames,
+                          unsigned long long *sum)
+{
+    long long   total;
+    long long   t0;
+    int         i;
+
+    g->sprite_mode = mode;
+    total = 0;
+    i = -BENCH_WARMUP;
+    while (i < frames)
+    {
+        if (spin)
+            setup_player(g, SPR_MAP / 2, SPR_MAP / 2,
+                         360.0f * ((i < 0) ? 0 : i) / frames);
+        render_scene(g);
+        if (i == 0)
+            *sum = frame_sum(&g->frame);
+        t0 = clock_ns();
+        render_pass(g, stage_sprites);
+        if (i >= 0)
+            total += clock_ns() - t0;
+        i++;
+    }
+    return (total / 1e6 / frames);
+}
+
+static void bench_blit(t_game *g, int frames)
+{
+    static const float  dist[] = { 0.6f, 1.5f, 4.0f };
+    unsigned long long  sk;
+    unsigned long long  sr;
+    double              keyed;
+    double              runs;
+    char                name[32];
+    int                 k;
+
+    destroy_tex(g, &tex_pokeball);
+    tex_pokeball.layout = TEX_COL_MAJOR;
+    if (!try_load_xpm_paths(g, &tex_pokeball, "pokeball.xpm")
+        || !sprite_runs_build(&pokeball_runs, &tex_pokeball))
+    {
+        printf("  (pokeball.xpm not found: keyed vs runs skipped)\n");
+        return ;
+    }
+    printf("sprite blit, pokeball.xpm %dx%d, %d opaque runs\n", tex_pokeball.w,
+           tex_pokeball.h, pokeball_runs.first[pokeball_runs.w]);
+    printf("  %-12s %12s %12s %8s %6s\n", "scene", "keyed ms", "runs ms", "speedup", "same");
+    k = 0;
+    while (k < 5)
+    {
+        if (k < 2)
+        {
+            arena_with_sprites(g, k ? 1000 : 100);
+            snprintf(name, sizeof(name), "spin %d", k ? 1000 : 100);
+        }
+        else
+        {
+            single_ball(g, dist[k - 2]);
+            snprintf(name, sizeof(name), "ball at %.1f", dist[k - 2]);
+        }
+        keyed = time_blit(g, SPRITE_KEYED, k < 2, frames, &sk);
+        runs = time_blit(g, SPRITE_RUNS, k < 2, frames, &sr);
+        printf("  %-12s %12.3f %12.3f %7.2fx %6s\n", name, keyed, runs,
+               runs > 0.0 ? keyed / runs : 0.0, sk == sr ? "yes" : "NO");
+        k++;
+    }
+    g->sprite_mode = SPRITE_RUNS;
+}
+
+/* Tour complet au centre de la carte chargée (côté side): une ligne du
+   tableau */
+static void spin_row(t_game *g, int side, int frames)
+{
+    long long   total;
+    long long   spr;
+    long long   vis;
+    long long   proj;
+    long long   pick;
+    long long   t0;
+    long long   t1;
+    int         i;
+
+    total = 0;
+    spr = 0;
+    vis = 0;
+    proj = 0;
+    pick = 0;
+    i = -BENCH_WARMUP;
+    while (i < frames)
+    {
+        setup_player(g, side / 2, side / 2, 360.0f * ((i < 0) ? 0 : i) / frames);
+        t0 = clock_ns();
+        render_scene(g);
+        t1 = clock_ns();
+        /* Seconde projection + passe seule: la part des sprites */
+        sprites_project(g);
+        if (g->svis_count > 0)
+            render_pass(g, stage_sprites);
+        if (i >= 0)
+        {
+            total += t1 - t0;
+            spr += clock_ns() - t1;
+            vis += g->svis_count;
+        }
+        t0 = clock_ns();
+        sprites_project(g);
+        t1 = clock_ns();
+        sprite_pickup(g);
+        if (i >= 0)
+        {
+            proj += t1 - t0;
+            pick += clock_ns() - t1;
+        }
+        i++;
+    }
+    printf("  %7d %10.1f %12.3f %12.3f %12.2f %12.3f\n", sprite_count,
+           (double)vis / frames, total / 1e6 / frames, spr / 1e6 / frames,
+           proj / 1e3 / frames, pick / 1e3 / frames);
+}
+
+int     bench_sprites(int argc, char **argv)
+{
+    t_game      g;
+    int         frames = (argc > 1) ? atoi(argv[1]) : BENCH_FRAMES / 2;
+    int         w = (argc > 2) ? atoi(argv[2]) : WIN_W;
+    int         h = (argc > 3) ? atoi(argv[3]) : WIN_H;
+    int         c;
+
+    if (frames < 1) frames = 1;
+    bench_game_init(&g, w, h);
+    g.drs.last.target_ms = 0.0;
+    printf("sprites, %dx%d, %d frames (360° spin in a %dx%d arena)\n",
+           w, h, frames, SPR_MAP, SPR_MAP);
+    printf("  %7s %10s %12s %12s %12s %12s\n", "sprites", "visible", "frame ms",
+           "sprites ms", "project us", "pickup us");
+    c = 0;
+    while (c < (int)(sizeof(g_counts) / sizeof(g_counts[0])))
+    {
+        arena_with_sprites(&g, g_counts[c]);
+        spin_row(&g, SPR_MAP, frames);
+        c++;
+    }
+    printf("  (same spin in a %dx%d map)\n", SPR_BIG, SPR_BIG);
+    big_with_sprites(&g, SPR_BIG);
+    spin_row(&g, SPR_BIG, frames);
+    bench_blit(&g, frames);
+    bench_game_free(&g);
+    return (0);
+}
@@ -0,0 +1,304 @@
+#include "bench.h"
+
+/* ==========================================================================
+**  Suite "verify" — test différentiel des traverseurs DDA
+**  --------------------------------------------------------------------------
+**  Référence: DDA scalaire case par case (trace_scalar, DDA_SKIP_NONE).
+**  Chaque traverseur disponible (scalar, sse4, avx2) × chaque mode de saut
+**  (none, field, mip) doit rendre exactement les mêmes impacts, bit à bit:
+**  case touchée, face, distance perpendiculaire et point d'impact.
+**
+**  Cartes (graine fixe): la carte du jeu, un champ ouvert 1024², un
+**  labyrinthe 256², du bruit à 5 / 20 / 40 % de murs et des piliers épars
+**  sur 2048². Caméras tirées au hasard sur des cases libres; une sur huit
+**  regarde selon un axe ou une diagonale exacte depuis un coin de case
+**  (égalités side_x == side_y: règle de départage des sauts). Puis VERIFY_EDITS cases basculées par map_set_cell
+**  (champ et pyramide mis à jour localement) et autant de caméras encore.
+**
+**  Le tableau compte les caméras en écart par traverseur et par mode; le
+**  premier écart est détaillé sur stderr et le code de sortie vaut 1.
+**
+**  Usage: poke3d_bench verify [caméras] [largeur] [hauteur]
+** ========================================================================== */
+
+#define VERIFY_EDITS 64
+
+static const char   *g_verify_dda[] = { "scalar", "sse4", "avx2", NULL };
+static const char   *g_verify_skip[] = { "none", "field", "mip" };
+
+typedef struct s_verify_map
+{
+    const char  *name;
+    int         n;          /* côté (0: carte du jeu) */
+    int         kind;       /* 0 ouvert, 1 labyrinthe, 2 bruit, 3 piliers */
+    int         pct;        /* bruit: % de murs */
+}   t_verify_map;
+
+static const t_verify_map   g_verify_maps[] = {
+    { "small", 0, 0, 0 },
+    { "open", 1024, 0, 0 },
+    { "maze", 256, 1, 0 },
+    { "noise5", 256, 2, 5 },
+    { "noise20", 256, 2, 20 },
+    { "noise40", 256, 2, 40 },
+    { "pillars", 2048, 3, 0 },
+    { NULL, 0, 0, 0 }
+};
+
+static unsigned int g_seed = 777;
+
+static unsigned int rnd(unsigned int n)
+{
+    g_seed = g_seed * 1103515245u + 12345u;
+    return ((g_seed >> 8) % n);
+}
+
+static void verify_map(t_game *g, const t_verify_map *m)
+{
+    char        *buf;
+    const char  **rows;
+    const int   n = m->n;
+    int         x;
+    int         y;
+    int         wall;
+
+    if (n == 0)
+    {
+        setup_map_small(g);
+        return ;
+    }
+    buf = (char *)malloc((size_t)n * (n + 1));
+    rows = (const char **)malloc(sizeof(char *) * (n + 1));
+    if (!buf || !rows)
+        panic("verify: malloc map");
+    y = 0;
+    while (y < n)
+    {
+        x = 0;
+        while (x < n)
+        {
+            wall = (x == 0 || y == 0 || x == n - 1 || y == n - 1);
+            if (m->kind == 1)
+                wall |= (x % 4 == 0 && y % 4 != 2) || (y % 4 == 0 && x % 4 != 2);
+            else if (m->kind == 2)
+                wall |= (int)rnd(100) < m->pct;
+            else if (m->kind == 3)
+                wall |= (x % 64 == 32 && y % 64 == 32);
+            buf[(size_t)y * (n + 1) + x] = wall ? '1' : '0';
+            x++;
+        }
+        buf[(size_t)y * (n + 1) + n] = '\0';
+        rows[y] = buf + (size_t)y * (n + 1);
+        y++;
+    }
+    rows[n] = NULL;
+    map_load_rows(g, rows);
+    free(rows);
+    free(buf);
+}
+
+/* Caméra c: case libre tirée au hasard; une sur huit au coin exact de la
+   case, regard selon un axe ou une diagonale exacte (|dir.x| == |dir.y|):
+   le rayon de la colonne centrale a side_x == side_y à chaque pas */
+static void verify_camera(t_game *g, int c)
+{
+    static const float  dirs[8][2] = { { 1, 0 }, { 1, 1 }, { 0, 1 }, { -1, 1 },
+                                       { -1, 0 }, { -1, -1 }, { 0, -1 }, { 1, -1 } };
+    float               len;
+    int                 x;
+    int                 y;
+    int                 i;
+
+    do
+    {
+        x = (int)rnd(g->map_w);
+        y = (int)rnd(g->map_h);
+    }
+    while (GRID_SOLID(&g->grid, x, y));
+    if (c % 8 == 0)
+    {
+        setup_player(g, 0, 0, 0.0f);
+        len = g->p.plane.y;
+        i = (int)rnd(8);
+        g->p.dir.x = dirs[i][0] * ((i & 1) ? 0.70710678f : 1.0f);
+        g->p.dir.y = dirs[i][1] * ((i & 1) ? 0.70710678f : 1.0f);
+        g->p.plane.x = -g->p.dir.y * len;
+        g->p.plane.y = g->p.dir.x * len;
+        g->p.pos.x = (float)x;
+        g->p.pos.y = (float)y;
+    }
+    else
+    {
+        setup_player(g, 0, 0, (float)rnd(36000) / 100.0f);
+        g->p.pos.x = x + (float)rnd(1024) / 1024.0f;
+        g->p.pos.y = y + (float)rnd(1024) / 1024.0f;
+    }
+    view_update(g);
+}
+
+/* Impacts copiés (références de la colonne x) */
+typedef struct s_verify_ref
+{
+    float   *perp;
+    float   *wall;
+    int     *mx;
+    int     *my;
+    int     *side;
+}   t_verify_ref;
+
+static void ref_take(t_verify_ref *r, const t_hits *h, int w)
+{
+    __builtin_memcpy(r->perp, h->perp_dist, sizeof(float) * w);
+    __builtin_memcpy(r->wall, h->wall_x, sizeof(float) * w);
+    __builtin_memcpy(r->mx, h->map_x, sizeof(int) * w);
+    __builtin_memcpy(r->my, h->map_y, sizeof(int) * w);
+    __builtin_memcpy(r->side, h->side, sizeof(int) * w);
+}
+
+/* Première colonne qui diffère de la référence, -1 si aucune */
+static int  ref_diff(const t_verify_ref *r, const t_hits *h, int w)
+{
+    int x;
+
+    x = 0;
+    while (x < w)
+    {
+        if (r->mx[x] != h->map_x[x] || r->my[x] != h->map_y[x]
+            || r->side[x] != h->side[x]
+            || __builtin_memcmp(&r->perp[x], &h->perp_dist[x], sizeof(float))
+            || __builtin_memcmp(&r->wall[x], &h->wall_x[x], sizeof(float)))
+            return (x);
+        x++;
+    }
+    return (-1);
+}
+
+/* Toutes les combinaisons sur la caméra courante; bad[d][k] compte les
+   caméras en écart (la première est détaillée sur stderr) */
+static void verify_view(t_game *g, t_verify_ref *r, int bad[3][3], int *ran)
+{
+    static int  told;
+    const int   w = g->view.w;
+    int         d;
+    int         k;
+    int         x;
+
+    setenv("POKE3D_DDA", "scalar", 1);
+    dda_select(g);
+    g->dda_skip = DDA_SKIP_NONE;
+    render_pass(g, stage_hits);
+    ref_take(r, &g->hits, w);
+    d = 0;
+    while (g_verify_dda[d])
+    {
+        setenv("POKE3D_DDA", g_verify_dda[d], 1);
+        dda_select(g);
+        k = DDA_SKIP_NONE;
+        while (!strcmp(g->dda_name, g_verify_dda[d]) && k <= DDA_SKIP_MIP)
+        {
+            ran[d] = 1;
+            g->dda_skip = k;
+            render_pass(g, stage_hits);
+            x = ref_diff(r, &g->hits, w);
+            if (x >= 0 && !told++)
+                fprintf(stderr, "verify: %s/%s pos (%.9g, %.9g) dir (%.9g, %.9g) col %d: "
+                        "cell (%d, %d) side %d perp %.9g, want (%d, %d) side %d perp %.9g\n",
+                        g_verify_dda[d], g_verify_skip[k], g->view.pos.x, g->view.pos.y,
+                        g->view.dir.x, g->view.dir.y, x, g->hits.map_x[x], g->hits.map_y[x],
+                        g->hits.side[x], g->hits.perp_dist[x], r->mx[x], r->my[x],
+                        r->side[x], r->perp[x]);
+            bad[d][k] += (x >= 0);
+            k++;
+        }
+        d++;
+    }
+}
+
+/* Caméras sur la carte m, puis (sauf carte du jeu) après VERIFY_EDITS
+   cases intérieures basculées; renvoie le nombre de caméras en écart */
+static int  verify_run(t_game *g, const t_verify_map *m, int cams, t_verify_ref *r)
+{
+    int bad[3][3] = { { 0 } };
+    int ran[3] = { 0 };
+    int views;
+    int sum;
+    int c;
+    int d;
+    int e;
+    int k;
+
+    verify_map(g, m);
+    views = 0;
+    k = 0;
+    while (k < (m->n ? 2 : 1))
+    {
+        c = 0;
+        while (c < cams)
+        {
+            verify_camera(g, c++);
+            verify_view(g, r, bad, ran);
+            views++;
+        }
+        e = 0;
+        while (m->n && k == 0 && e++ < VERIFY_EDITS)
+        {
+            c = 1 + (int)rnd(g->map_w - 2);
+            d = 1 + (int)rnd(g->map_h - 2);
+            map_set_cell(g, c, d, GRID_SOLID(&g->grid, c, d) ? '0' : '1');
+        }
+        k++;
+    }
+    sum = 0;
+    d = 0;
+    while (g_verify_dda[d])
+    {
+        if (ran[d])
+            printf("  %-8s %6d %8d %-7s %6d %6d %6d\n", m->name, g->map_w,
+                   views * g->view.w, g_verify_dda[d], bad[d][0], bad[d][1], bad[d][2]);
+        sum += bad[d][0] + bad[d][1] + bad[d][2];
+        d++;
+    }
+    return (sum);
+}
+
+int     bench_verify(int argc, char **argv)
+{
+    t_game          g;
+    t_verify_ref    r;
+    int             cams = (argc > 1) ? atoi(argv[1]) : 100;
+    int             w = (argc > 2) ? atoi(argv[2]) : WIN_W;
+    int             h = (argc > 3) ? atoi(argv[3]) : WIN_H;
+    int             ok;
+    int             i;
+
+    if (cams < 1) cams = 1;
+    bench_game_init(&g, w, h);
+    r.perp = (float *)malloc(sizeof(float) * g.frame.w);
+    r.wall = (float *)malloc(sizeof(float) * g.frame.w);
+    r.mx = (int *)malloc(sizeof(int) * g.frame.w);
+    r.my = (int *)malloc(sizeof(int) * g.frame.w);
+    r.side = (int *)malloc(sizeof(int) * g.frame.w);
+    if (!r.perp || !r.wall || !r.mx || !r.my || !r.side)
+        panic("verify: malloc");
+    printf("verify, hits vs per-cell scalar DDA, %d cameras per map (+ after %d edits)\n",
+           cams, VERIFY_EDITS);
+    printf("  %-8s %6s %8s %-7s %6s %6s %6s\n", "map", "size", "rays", "dda",
+           "none", "field", "mip");
+    ok = 1;
+    i = 0;
+    while (g_verify_maps[i].name)
+    {
+        if (verify_run(&g, &g_verify_maps[i], cams, &r) > 0)
+            ok = 0;
+        i++;
+    }
+    unsetenv("POKE3D_DDA");
+    printf("%s\n", ok ? "verify: all traversers match" : "verify: MISMATCH");
+    free(r.perp);
+    free(r.wall);
+    free(r.mx);
+    free(r.my);
+    free(r.side);
+    bench_game_free(&g);
+    return (ok ? 0 : 1);
+}
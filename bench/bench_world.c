@@ -0,0 +1,274 @@
+#include "bench.h"
+
+/* ==========================================================================
+**  Suite "world" — monde en chunks paginé depuis le disque (world.c)
+**  --------------------------------------------------------------------------
+**  Monde de 128 × 128 chunks (8192² cases, 64 Mo en grille) écrit dans
+**  /tmp (graine fixe): piliers tous les 16 cases et 1 % de bruit, un
+**  chunk sur cinq vide, quelques-uns pleins, et une avenue libre le long
+**  de +X. Le joueur y marche à pas cellules par frame, puis revient (le
+**  retour relit la fenêtre de l'aller: succès du cache, ou évictions si
+**  le budget est serré). Chaque frame: world_update puis render_scene,
+**  cadencées à une frame par période (temps réel: le thread de lecture
+**  avance pendant l'attente comme entre deux frames du jeu, et la vitesse
+**  de marche ne dépend pas de la vitesse du rendu).
+**
+**  Scénarios: disque rapide ou lent (POKE3D_WORLD_DELAY_US par lecture),
+**  avec ou sans préchargement dans le sens de la marche, budget normal
+**  ou serré. Colonnes:
+**    - tick p50 / p99 / max : world_update + rendu, ms
+**    - upd max : world_update seul (recentrage compris), ms
+**    - fog %   : rayons arrêtés sur un chunk pas encore lu
+**    - fog fr  : frames avec au moins un tel rayon
+**    - reads / hits / evict / shifts : compteurs de t_world
+**    - cache   : Ko du cache (slots + hachage) / budget
+**    - check   : chunks de la fenêtre comparés au générateur toutes les
+**                32 frames (lus = identiques, brouillard = pleins)
+**
+**  Usage: poke3d_bench world [frames] [délai us] [pas] [période ms]
+**                            [largeur] [hauteur]
+** ========================================================================== */
+
+#define WB_SIDE     128
+#define WB_LANE     (64 * WORLD_CHUNK + 32)     /* ligne de l'avenue */
+#define WB_CELLS    (WORLD_SPAN * WORLD_CHUNK)
+
+typedef struct s_wb_case
+{
+    const char  *name;
+    int         slow;       /* délai de lecture (sinon 0) */
+    int         ahead;      /* chunks préchargés devant */
+    const char  *mb;        /* POKE3D_WORLD_MB */
+}   t_wb_case;
+
+static const t_wb_case  g_wb_cases[] = {
+    { "fast", 0, WORLD_AHEAD, "16" },
+    { "fast/noahead", 0, 0, "16" },
+    { "slow", 1, WORLD_AHEAD, "16" },
+    { "slow/noahead", 1, 0, "16" },
+    { "slow/tight", 1, WORLD_AHEAD, "0.08" },
+    { NULL, 0, 0, NULL }
+};
+
+static unsigned int wb_hash(int x, int y)
+{
+    unsigned int    h;
+
+    h = (unsigned int)x * 73856093u ^ (unsigned int)y * 19349663u;
+    h ^= h >> 13;
+    h *= 0x5bd1e995u;
+    return (h ^ (h >> 15));
+}
+
+/* Générateur du monde (t_world_gen): aussi la référence du contrôle */
+static void wb_gen(void *ctx, int cx, int cy, unsigned long long *rows)
+{
+    int wx;
+    int wy;
+    int x;
+    int y;
+
+    (void)ctx;
+    y = 0;
+    while (y < WORLD_CHUNK)
+    {
+        rows[y] = 0;
+        wy = cy * WORLD_CHUNK + y;
+        x = 0;
+        while (x < WORLD_CHUNK && (cx + cy) % 5 != 0)
+        {
+            wx = cx * WORLD_CHUNK + x;
+            if ((cy != WB_LANE / WORLD_CHUNK && (cx * 7 + cy * 13) % 23 == 0)
+                || (abs(wy - WB_LANE) > 2
+                    && ((wx % 16 == 8 && wy % 16 == 8) || wb_hash(wx, wy) % 100 == 0)))
+                rows[y] |= 1ull << x;
+            x++;
+        }
+        y++;
+    }
+}
+
+/* Chunks de la fenêtre qui ne sont pas ce qu'ils doivent être */
+static int  wb_check(const t_game *g)
+{
+    const t_world       *w = &g->world;
+    unsigned long long  rows[WORLD_CHUNK];
+    int                 bad;
+    int                 c;
+    int                 x;
+    int                 y;
+    int                 want;
+
+    bad = 0;
+    c = 0;
+    while (c < WORLD_SPAN * WORLD_SPAN)
+    {
+        if (w->state[c] == WCHUNK_LOADED)
+            wb_gen(NULL, w->ox + c % WORLD_SPAN, w->oy + c / WORLD_SPAN, rows);
+        y = 0;
+        while (y < WORLD_CHUNK * WORLD_CHUNK)
+        {
+            x = y % WORLD_CHUNK;
+            want = (w->state[c] != WCHUNK_LOADED) || ((rows[y / WORLD_CHUNK] >> x) & 1);
+            if (GRID_SOLID(&g->grid, c % WORLD_SPAN * WORLD_CHUNK + x,
+                           c / WORLD_SPAN * WORLD_CHUNK + y / WORLD_CHUNK) != want)
+                break ;
+            y++;
+        }
+        bad += (y < WORLD_CHUNK * WORLD_CHUNK);
+        c++;
+    }
+    return (bad);
+}
+
+/* Rayons de la dernière passe arrêtés sur un chunk en brouillard */
+static int  wb_fog_rays(const t_game *g)
+{
+    int n;
+    int x;
+    int mx;
+    int my;
+
+    n = 0;
+    x = 0;
+    while (x < g->view.w)
+    {
+        mx = g->hits.map_x[x];
+        my = g->hits.map_y[x];
+        if (mx >= 0 && my >= 0 && mx < WB_CELLS && my < WB_CELLS
+            && g->world.state[my / WORLD_CHUNK * WORLD_SPAN + mx / WORLD_CHUNK]
+               == WCHUNK_FOG)
+            n++;
+        x++;
+    }
+    return (n);
+}
+
+static int  cmp_ll(const void *a, const void *b)
+{
+    const long long x = *(const long long *)a;
+    const long long y = *(const long long *)b;
+
+    return ((x > y) - (x < y));
+}
+
+/* Aller-retour sur l'avenue; renvoie le nombre de contrôles en échec */
+static int  wb_walk(t_game *g, const t_wb_case *k, const char *path, int frames,
+                    float step, long long period, long long *tick)
+{
+    const t_world   *w = &g->world;
+    long long       start;
+    long long       t0;
+    long long       t1;
+    long long       upd;
+    long long       fog;
+    int             fog_frames;
+    int             bad;
+    int             i;
+
+    if (!world_open(g, path))
+        panic("world: cannot open the test world");
+    g->world.ahead = k->ahead;
+    upd = 0;
+    fog = 0;
+    fog_frames = 0;
+    bad = 0;
+    start = clock_ns();
+    i = 0;
+    while (i < frames)
+    {
+        t0 = start + i * period - clock_ns();
+        if (t0 > 0)
+            usleep((useconds_t)(t0 / 1000));
+        if (i == frames / 2)
+        {
+            /* Demi-tour: même avenue dans l'autre sens */
+            g->p.dir.x = -g->p.dir.x;
+            g->p.dir.y = -g->p.dir.y;
+            g->p.plane.x = -g->p.plane.x;
+            g->p.plane.y = -g->p.plane.y;
+        }
+        g->p.vel.x = g->p.dir.x * step;
+        g->p.vel.y = 0.0f;
+        g->p.pos.x += g->p.vel.x;
+        t0 = clock_ns();
+        world_update(g);
+        t1 = clock_ns();
+        render_scene(g);
+        tick[i] = clock_ns() - t0;
+        if (t1 - t0 > upd)
+            upd = t1 - t0;
+        fog += wb_fog_rays(g);
+        fog_frames += (wb_fog_rays(g) > 0);
+        if (i % 32 == 31 || i == frames - 1)
+            bad += (wb_check(g) > 0);
+        i++;
+    }
+    qsort(tick, frames, sizeof(long long), cmp_ll);
+    printf("  %-13s %7.2f %7.2f %7.2f %7.2f %6.2f %6d %6lld %6lld %6lld %6lld %6.0f/%-6.0f %s\n",
+           k->name, tick[frames / 2] / 1e6, tick[frames * 99 / 100] / 1e6,
+           tick[frames - 1] / 1e6, upd / 1e6, 100.0 * fog / ((double)frames * g->view.w),
+           fog_frames, w->reads, w->hits, w->evictions, w->shifts,
+           (w->slot_count * (double)sizeof(t_chunk_slot)
+            + (w->bucket_mask + 1) * (double)sizeof(int)) / 1024,
+           strtod(k->mb, NULL) * 1024, bad ? "FAIL" : "ok");
+    return (bad);
+}
+
+int     bench_world(int argc, char **argv)
+{
+    static const char   *path = "/tmp/poke3d_bench_world.p3w";
+    t_game              g;
+    t_spawn             sp;
+    long long           *tick;
+    long long           t0;
+    int                 frames = (argc > 1) ? atoi(argv[1]) : 600;
+    int                 delay = (argc > 2) ? atoi(argv[2]) : 20000;
+    float               step = (argc > 3) ? (float)atof(argv[3]) : 3.0f;
+    double              period = (argc > 4) ? atof(argv[4]) : 8.0;
+    int                 w = (argc > 5) ? atoi(argv[5]) : 320;
+    int                 h = (argc > 6) ? atoi(argv[6]) : 200;
+    char                buf[32];
+    int                 bad;
+    int                 i;
+
+    if (frames < 2) frames = 2;
+    if (step <= 0.0f || step >= WORLD_CHUNK) step = 3.0f;
+    if (period < 0.0) period = 0.0;
+    sp.x = 4 * WORLD_CHUNK + 8;
+    sp.y = WB_LANE;
+    sp.deg = 0.0f;
+    t0 = clock_ns();
+    if (!world_write(path, &sp, WB_SIDE, WB_SIDE, wb_gen, NULL))
+        panic("world: cannot write the test world");
+    printf("world, %dx%d chunks of %d² cells written in %.0f ms; %dx%d, %d frames"
+           " every %.1f ms, %.1f cells/frame out and back, slow disk %d us/chunk\n",
+           WB_SIDE, WB_SIDE, WORLD_CHUNK, (clock_ns() - t0) / 1e6, w, h, frames,
+           period, step, delay);
+    tick = (long long *)malloc(sizeof(long long) * frames);
+    if (!tick)
+        panic("world: malloc");
+    bench_game_init(&g, w, h);
+    g.drs.last.target_ms = 0.0;
+    printf("  %-13s %7s %7s %7s %7s %6s %6s %6s %6s %6s %6s %13s %s\n", "case",
+           "p50 ms", "p99 ms", "max ms", "upd max", "fog %", "fog fr", "reads",
+           "hits", "evict", "shifts", "cache KB", "check");
+    bad = 0;
+    i = 0;
+    while (g_wb_cases[i].name)
+    {
+        snprintf(buf, sizeof(buf), "%d", g_wb_cases[i].slow ? delay : 0);
+        setenv("POKE3D_WORLD_DELAY_US", buf, 1);
+        setenv("POKE3D_WORLD_MB", g_wb_cases[i].mb, 1);
+        bad += wb_walk(&g, &g_wb_cases[i], path, frames, step,
+                       (long long)(period * 1e6), tick);
+        i++;
+    }
+    unsetenv("POKE3D_WORLD_DELAY_US");
+    unsetenv("POKE3D_WORLD_MB");
+    printf("%s\n", bad ? "world: MISMATCH" : "world: window matches the generator");
+    free(tick);
+    bench_game_free(&g);
+    unlink(path);
+    return (bad ? 1 : 0);
+}
@@ -18,11 +18,100 @@
 **    4) On calcule la distance "perpendiculaire" au mur et on dessine une bande verticale.
 ** ============================= */
 
+/* Taille de fenêtre et FOV PAR DÉFAUT: les valeurs effectives vivent dans
+** t_game (win_w, win_h, fov) et se règlent par fichier de config ou ligne de
+** commande (voir config.c). Les touches - et = parcourent RES_PRESETS. */
 # define WIN_W 1280
 # define WIN_H 720
+# define RES_MIN 16
+# define RES_MAX 16384
+# define RES_PRESETS { {640, 360}, {960, 540}, {1280, 720}, {1600, 900}, \
+                       {1920, 1080}, {2560, 1440}, {3840, 2160} }
 
 /* FOV (Field Of View). 60° donne un rendu confortable. */
 # define FOV (60.0f)
+# define FOV_MIN 10.0f
+# define FOV_MAX 170.0f
+
+/* Nombre de threads de rendu (0 = auto: un par cœur en ligne).
+** Surchargeable à l'exécution via la variable d'environnement POKE3D_THREADS. */
+# define RENDER_THREADS 0
+# define MAX_THREADS    256
+
+/* Largeur (en colonnes) d'une tuile du scheduler work-stealing.
+** Surchargeable via POKE3D_TILE; POKE3D_SCHED_STATS=1 affiche les stats. */
+# define TILE_COLS          16
+# define SCHED_REPORT_EVERY 60
+
+/* Rendu à la demande: loop_hook ne recalcule la frame que si quelque chose
+** a changé (bits DIRTY_*). Le ciel défile d'un texel toutes les
+** SKY_SCROLL_MS millisecondes (0 = ciel fixe); sans rien à faire, la boucle
+** dort IDLE_SLEEP_US microsecondes au lieu de tourner à vide. */
+# define DIRTY_CAMERA  (1u << 0)   /* position / direction du joueur */
+# define DIRTY_SKY     (1u << 1)   /* défilement du ciel */
+# define DIRTY_MAP     (1u << 2)   /* contenu de la carte */
+# define DIRTY_EXPOSE  (1u << 3)   /* fenêtre à ré-afficher (image inchangée) */
+# define DIRTY_HUD     (1u << 4)   /* surcouche (profileur) affichée / masquée */
+# define DIRTY_ALL     (DIRTY_CAMERA | DIRTY_SKY | DIRTY_MAP | DIRTY_EXPOSE | DIRTY_HUD)
+# define SKY_SCROLL_MS 100
+# define IDLE_SLEEP_US 4000
+
+/* Résolution dynamique: le rendu se fait dans une cible interne réduite
+** par paliers (DRS_LEVELS, en % de la fenêtre) puis agrandie dans l'image
+** MLX. Le gouverneur vise DRS_TARGET_MS par frame (POKE3D_FRAME_MS,
+** 0 = désactivé) et n'agit qu'après DRS_COOLDOWN frames au même palier.
+** Sans affichage (--headless), il est désactivé sauf POKE3D_FRAME_MS
+** explicite: taille de rendu et sortie reproductibles d'une machine à
+** l'autre.
+** POKE3D_DRS_STATS=1 affiche chaque décision sur stderr. */
+# define DRS_TARGET_MS  16.7f
+# define DRS_LEVELS     { 100, 90, 80, 70, 60, 50 }
+# define DRS_COOLDOWN   30
+# define DRS_DOWN       1.10f   /* lissé > cible * DRS_DOWN  -> palier inférieur */
+# define DRS_UP         0.70f   /* lissé < cible * DRS_UP    -> palier supérieur */
+
+/* Profileur par étape: compilé seulement avec -DPOKE3D_PROFILE
+** (make PROFILE=1); sinon les macros PROF_* ne génèrent aucun code.
+** Temps par étape agrégés par frame dans un anneau de PROF_RING frames;
+** la touche P (ou POKE3D_PROFILE_OVERLAY=1) affiche barres + graphe FPS.
+** POKE3D_PERF=1 ajoute les compteurs matériels (voir PMU_*). */
+# define PROF_EVENTS    0   /* entre deux loop_hook: événements X, XSync */
+# define PROF_DDA       1
+# define PROF_SKY       2
+# define PROF_FLOOR     3
+# define PROF_WALLS     4
+# define PROF_TRANSPOSE 5
+# define PROF_UPSCALE   6
+# define PROF_PRESENT   7
+# define PROF_SPRITES   8
+# define PROF_COUNT     9
+# define PROF_RING      128
+
+/* Compteurs matériels (perf_event_open) par thread et par étape, dans la
+** build profileur avec POKE3D_PERF=1: IPC et défauts de cache par pixel. */
+# define PMU_CYCLES     0
+# define PMU_INSTR      1
+# define PMU_L1D_MISS   2
+# define PMU_LLC_MISS   3
+# define PMU_BR_MISS    4
+# define PMU_COUNT      5
+
+/* Trace d'événements au format Chrome / Perfetto: compilée avec
+** -DPOKE3D_TRACE (make TRACE=1), activée par POKE3D_TRACE=fichier.json.
+** Deux tampons de TRACE_CAP événements par thread: l'un se remplit pendant
+** que l'autre est écrit par un thread d'écriture. */
+# define TRACE_CAP      16384
+
+/* Sprites (Pokéballs, cases 'C' de la carte): côté du billboard en
+** fraction de la hauteur d'un mur, profondeur minimale dessinée et rayon
+** de ramassage (en cases). */
+# define SPRITE_SCALE    0.35f
+# define SPRITE_NEAR     0.2f
+# define SPRITE_PICKUP_R 0.45f
+
+/* Mode sans affichage (--headless ou POKE3D_BACKEND=headless): nombre de
+** frames rendues par défaut avant de quitter. */
+# define HEADLESS_FRAMES 300
 
 /* Vitesse de déplacement / rotation (à adapter à votre goût). */
 # define MOVE_SPEED 0.08f
@@ -36,12 +125,17 @@
 # define KEY_D     100
 # define KEY_LEFT  65361
 # define KEY_RIGHT 65363
+# define KEY_MINUS  45
+# define KEY_EQUAL  61
+# define KEY_P     112
 
 /* ---------- INCLUDES SYSTÈME / MLX ---------- */
 # include <stdlib.h>
 # include <stdbool.h>
 # include <unistd.h>
 # include <math.h>
+# include <pthread.h>
+# include <stdatomic.h>
 # include <X11/keysym.h>
 # include <X11/X.h>
 # include "./mlx/mlx.h"
@@ -67,11 +161,183 @@ typedef struct s_img
     int     endian;
     int     w;
     int     h;
+    int     layout;     /* TEX_ROW_MAJOR (défaut) ou TEX_COL_MAJOR */
+    unsigned int *px;   /* copie privée 32 bits transposée si TEX_COL_MAJOR */
+    unsigned int **rows; /* début de chaque ligne (API span), NULL si non construit */
+    int     xstep;      /* pixels entre deux colonnes voisines (1 en row-major) */
+    int     ystep;      /* pixels entre deux lignes voisines (1 en column-major) */
 }   t_img;
 
-/* Texture = image 2D utilisée pour recouvrir les murs/sols/ciels */
+/* Source d'une span verticale texturée: le texel i est
+** texels[clamp((int)(pos + i * step), 0, len - 1) * stride]. */
+typedef struct s_span_src
+{
+    const unsigned int  *texels;
+    int                 stride; /* pixels entre deux texels verticaux */
+    int                 len;    /* hauteur de la texture */
+    float               pos;    /* position texture de la première ligne */
+    float               step;   /* texels par pixel écran */
+}   t_span_src;
+
+/* Disposition mémoire d'une texture. Les murs sont lus verticalement
+** (une colonne de texture par bande d'écran): stockés transposés, une
+** bande lit des texels contigus. Ciel et sol sont lus par lignes. */
+# define TEX_ROW_MAJOR 0
+# define TEX_COL_MAJOR 1
+
+/* Mode du framebuffer: écriture directe dans l'image MLX, ou murs écrits
+** dans un buffer column-major puis transposés par blocs avant l'affichage.
+** Choisi via POKE3D_FB=transposed. */
+# define FB_DIRECT     0
+# define FB_TRANSPOSED 1
+
+/* Texture = image 2D utilisée pour recouvrir les murs/sols/ciels.
+** Chargée si addr != NULL; img n'est renseigné que pour une image MLX. */
 typedef t_img t_tex;
 
+/* Clés de couleur XPM d'au plus 3 caractères (table directe de 95^3). */
+# define XPM_MAX_CPP 3
+
+/* Grille de la carte, contiguë, une ligne de cases pleines tout autour:
+** les cases (x, y) pour x ∈ [-1, map_w] et y ∈ [-1, map_h] existent, et un
+** rayon parti d'une case libre touche toujours un mur avant d'en sortir.
+** La DDA avance donc sans aucun test de bornes. Un octet par case (le
+** gather AVX2 lit des octets); lignes de stride octets, stride multiple de
+** GRID_ALIGN. Trois plans de même disposition:
+**   solid : 1 = mur
+**   attr  : attribut de la case (id de texture du mur; 0 = tex_wall)
+**   field : distance de Chebyshev au mur le plus proche (0 = mur), bornée
+**           à DF_MAX. Une case à distance k a tout son carré de rayon
+**           k - 1 vide: la DDA y saute plusieurs cases d'un coup (dfield.c)
+** Plus une pyramide d'occupation (mip.c): mip[0] = solid, et la case
+** (i, j) du niveau l vaut 1 si le bloc de 2^l × 2^l cases du plan qu'elle
+** couvre contient un mur. Coordonnées du plan: (x + 1, y + 1). */
+# define GRID_ALIGN 16
+# define GRID_MIP   16      /* niveaux au plus: blocs jusqu'à 32768² cases */
+# define DF_MAX     255
+# define DF_MIN_SKIP 3      /* distance à partir de laquelle un saut paie */
+# define MIP_MIN_LEVEL 2    /* plus petit bloc sauté: 4 × 4 cases */
+
+typedef struct s_grid
+{
+    unsigned char   *solid;     /* (map_h + 2) × stride, bord compris */
+    unsigned char   *attr;
+    unsigned char   *cells;     /* solid + stride + 1: case (0, 0) */
+    unsigned char   *tex;       /* attr + stride + 1 */
+    unsigned char   *field;
+    unsigned char   *dist;      /* field + stride + 1 */
+    int             stride;     /* octets par ligne, >= map_w + 2 */
+    unsigned char   *mip[GRID_MIP];
+    int             mip_w[GRID_MIP];    /* largeur (= stride) de chaque niveau */
+    int             mip_h[GRID_MIP];
+    int             mip_levels; /* niveau le plus grossier (>= 1 si bâti) */
+}   t_grid;
+
+/* Case (x, y), x ∈ [-1, map_w], y ∈ [-1, map_h]: pas de test de bornes */
+# define GRID_SOLID(gr, x, y) ((gr)->cells[(long)(y) * (gr)->stride + (x)])
+# define GRID_TEX(gr, x, y)   ((gr)->tex[(long)(y) * (gr)->stride + (x)])
+# define GRID_DIST(gr, x, y)  ((gr)->dist[(long)(y) * (gr)->stride + (x)])
+/* Bloc (i, j) du niveau l, en coordonnées du plan décalées de l */
+# define GRID_MIP_AT(gr, l, i, j) ((gr)->mip[l][(long)(j) * (gr)->mip_w[l] + (i)])
+
+/* Point de départ lu dans un fichier de carte: 'P' (regard +X), ou
+** 'N' / 'S' / 'E' / 'W' (regard vers -Y / +Y / +X / -X) */
+typedef struct s_spawn
+{
+    int     x;
+    int     y;
+    float   deg;
+}   t_spawn;
+
+/* Chargement d'un fichier de carte (map_load_file): octets lus et temps
+** de chaque phase, pour le débit affiché / mesuré */
+typedef struct s_map_stats
+{
+    long long   bytes;
+    long long   scan_ns;    /* passe de validation (dimensions, spawns, 'C') */
+    long long   fill_ns;    /* grille + sprites écrits depuis le fichier */
+    long long   derive_ns;  /* champ de distance, pyramide, index des sprites */
+}   t_map_stats;
+
+/* Monde en chunks (world.c, --world FICHIER): la carte vit sur disque en
+** chunks de WORLD_CHUNK × WORLD_CHUNK cases (une ligne = 64 bits) derrière
+** un index. Seule une fenêtre de WORLD_SPAN² chunks centrée sur le joueur
+** est en mémoire, dans g->grid, en coordonnées locales (origine flottante:
+** le chunk du monde (ox, oy) est au coin de la fenêtre); la DDA n'en sait
+** rien. Un chunk pas encore lu est plein (mur de brouillard). Les chunks
+** lus restent dans un cache LRU borné par POKE3D_WORLD_MB; un thread les
+** lit en arrière-plan, ceux de la fenêtre d'abord puis ceux des fenêtres
+** à 1..WORLD_AHEAD chunks devant le joueur (sens de p.vel). */
+# define WORLD_CHUNK    64
+# define WORLD_RADIUS   3       /* fenêtre: chunks autour de celui du joueur */
+# define WORLD_SPAN     (2 * WORLD_RADIUS + 1)
+# define WORLD_AHEAD    2
+# define WORLD_CACHE_MB 16
+# define WORLD_QUEUE    64      /* lectures en cours au plus */
+
+/* État d'un chunk de la fenêtre */
+# define WCHUNK_FOG     0       /* pas encore lu: plein */
+# define WCHUNK_LOADED  1
+# define WCHUNK_OUTSIDE 2       /* hors du monde: plein pour toujours */
+
+/* Entrée du cache: un chunk (bit x de rows[y] = mur en (x, y)) */
+typedef struct s_chunk_slot
+{
+    unsigned long long  rows[WORLD_CHUNK];
+    int                 key;    /* cy * cw + cx, -1 si libre */
+    int                 ready;  /* 0 tant que le thread le lit */
+    int                 prev;   /* liste LRU (chunks lus), -1 = bout */
+    int                 next;
+    int                 hnext;  /* chaîne de sa case du hachage */
+}   t_chunk_slot;
+
+typedef struct s_world
+{
+    bool            active;
+    int             fd;
+    int             cw;         /* taille du monde en chunks */
+    int             ch;
+    int             ox;         /* chunk du monde au coin de la fenêtre */
+    int             oy;
+    int             ahead;      /* chunks préchargés devant (WORLD_AHEAD) */
+    unsigned char   state[WORLD_SPAN * WORLD_SPAN];    /* WCHUNK_* */
+    t_chunk_slot    *slots;     /* cache: slot_count entrées */
+    int             slot_count;
+    int             *bucket;    /* hachage clé -> premier slot, -1 si vide */
+    int             bucket_mask;
+    int             lru_head;   /* le plus récent */
+    int             lru_tail;
+    int             free_head;  /* slots libres (chaînés par next) */
+    int             loading;    /* slots en lecture */
+    /* Thread de lecture: file de demandes et de slots lus (sous mu) */
+    pthread_t       thread;
+    pthread_mutex_t mu;
+    pthread_cond_t  cv;
+    int             req[WORLD_QUEUE];
+    int             req_head;
+    int             req_n;
+    int             done[WORLD_QUEUE];
+    int             done_n;
+    bool            stop;
+    int             delay_us;   /* POKE3D_WORLD_DELAY_US: disque lent simulé */
+    /* Compteurs */
+    long long       reads;      /* chunks lus sur disque */
+    long long       hits;       /* chunks de fenêtre trouvés dans le cache */
+    long long       evictions;
+    long long       shifts;     /* recentrages de la fenêtre */
+}   t_world;
+
+/* Remplit les lignes du chunk (cx, cy) d'un monde écrit par world_write */
+typedef void (*t_world_gen)(void *ctx, int cx, int cy, unsigned long long *rows);
+
+/* Sauts d'espace vide de la DDA (g->dda_skip, POKE3D_SKIP) */
+enum e_dda_skip
+{
+    DDA_SKIP_NONE = 0,  /* case par case */
+    DDA_SKIP_FIELD,     /* champ de distance (dfield.c) */
+    DDA_SKIP_MIP        /* pyramide d'occupation (mip.c) */
+};
+
 /* État des touches pour un mouvement fluide (on évite la logique "à l'événement"). */
 typedef struct s_keys
 {
@@ -90,30 +356,464 @@ typedef struct s_player
     t_v2f   pos;        /* position en cases (x,y), ex: (3.5, 2.2) */
     t_v2f   dir;        /* direction du regard (unitaire) */
     t_v2f   plane;      /* vecteur perpendiculaire à dir qui définit l'ouverture du FOV */
+    t_v2f   vel;        /* déplacement du dernier tick (move_and_rotate) */
 }   t_player;
 
+/* Instantané de la caméra pris au début de chaque frame.
+** Les threads de rendu ne lisent QUE cette copie (jamais g->p ni g->tick),
+** ce qui rend cast_column sûr en parallèle: rien n'est modifié pendant le rendu. */
+typedef struct s_view
+{
+    t_v2f   pos;
+    t_v2f   dir;
+    t_v2f   plane;
+    int     sky_off;    /* décalage du ciel (défilement) figé pour la frame */
+    int     w;          /* taille de l'écran de rendu (colonnes, lignes) */
+    int     h;
+}   t_view;
+
+/* Pool de threads persistant (créé une fois au démarrage).
+** Le thread principal est le worker 0; les threads 1..count-1 dorment sur
+** une condition et se réveillent à chaque pool_run pour exécuter le job. */
+typedef void (*t_job)(void *arg, int worker, int nworkers);
+
+/* Argument d'un worker: son pool et son index (un par thread, dans le pool) */
+typedef struct s_worker_arg
+{
+    struct s_pool   *pool;
+    int             id;
+}   t_worker_arg;
+
+typedef struct s_pool
+{
+    pthread_t       *threads;
+    t_worker_arg    *args;      /* args[i] passé au thread i */
+    int             count;      /* nombre de workers, thread principal inclus */
+    pthread_mutex_t lock;
+    pthread_cond_t  wake;       /* signalé quand un nouveau job est publié */
+    pthread_cond_t  done;       /* signalé quand le dernier worker a fini */
+    t_job           job;
+    void            *arg;
+    unsigned        generation; /* incrémenté à chaque job publié */
+    int             pending;    /* workers (hors principal) encore occupés */
+    bool            quit;
+}   t_pool;
+
+/* Deque de tuiles d'un worker. top et bottom sont empaquetés dans un seul
+** mot atomique (top << 32 | bottom): le propriétaire dépile par le bas,
+** les voleurs par le haut, et un seul CAS arbitre le dernier élément. */
+typedef struct s_deque
+{
+    _Atomic unsigned long long  span;
+    int                         *tiles;     /* indices de tuiles, figés pendant la frame */
+    char                        pad[64 - sizeof(unsigned long long) - sizeof(int *)];
+}   t_deque;
+
+/* Compteurs d'un worker pour une frame (alignés pour éviter le faux partage). */
+typedef struct s_wstats
+{
+    long long   busy_ns;    /* temps passé dans les tuiles */
+    int         tiles;      /* tuiles exécutées */
+    int         steals;     /* tuiles volées à un autre worker */
+    char        pad[64 - sizeof(long long) - 2 * sizeof(int)];
+}   t_wstats;
+
+/* Statistiques de déséquilibre de charge d'une frame. */
+typedef struct s_sched_stats
+{
+    double      frame_ms;   /* durée murale de la passe */
+    double      mean_busy_ms;
+    double      max_busy_ms;
+    double      imbalance;  /* max_busy / mean_busy (1.0 = parfait) */
+    int         steals;
+    int         tiles;
+    int         tile_w;
+}   t_sched_stats;
+
+/* Job par tuile: rend les colonnes [x0, x1) sur le worker donné. */
+typedef void (*t_tile_fn)(void *arg, int x0, int x1, int worker);
+
+/* Scheduler work-stealing à tuiles de colonnes. */
+typedef struct s_sched
+{
+    t_deque         *deques;    /* un deque par worker */
+    t_wstats        *ws;
+    int             nworkers;
+    int             width;      /* nombre de colonnes à couvrir */
+    int             tile_w;
+    int             ntiles;
+    t_tile_fn       fn;
+    void            *arg;
+    t_sched_stats   last;       /* stats de la dernière passe */
+    bool            report;     /* affichage périodique sur stderr */
+    int             frames;
+    double          acc_imbalance;
+    double          max_imbalance;
+}   t_sched;
+
+/* Décision du gouverneur de résolution pour la dernière frame. */
+# define DRS_HOLD  0
+# define DRS_LOWER 1
+# define DRS_RAISE 2
+
+/* État publié par le gouverneur (drs_stats). */
+typedef struct s_drs_stats
+{
+    int         level;      /* index du palier courant (0 = pleine résolution) */
+    int         pct;        /* échelle du palier, en % de la fenêtre */
+    int         rt_w;       /* taille de la cible interne */
+    int         rt_h;
+    double      target_ms;  /* budget (0 = gouverneur désactivé) */
+    double      last_ms;    /* dernière frame mesurée (rendu + agrandissement) */
+    double      ema_ms;     /* moyenne lissée utilisée pour décider */
+    int         decision;   /* DRS_HOLD / DRS_LOWER / DRS_RAISE */
+    int         lowered;    /* nombre total de baisses */
+    int         raised;     /* nombre total de hausses */
+    const char  *upscale;   /* noyau d'agrandissement choisi */
+}   t_drs_stats;
+
+/* Agrandit une ligne: dst[x] = src[xs[x]] pour x dans [0, n). */
+typedef void (*t_upscale_fn)(const unsigned int *src, const int *xs,
+                             unsigned int *dst, int n);
+
+/* Gouverneur + tables d'agrandissement (plus proche voisin). */
+typedef struct s_drs
+{
+    int             level;
+    int             nlevels;
+    int             cooldown;   /* frames restantes avant une nouvelle décision */
+    double          ema_ms;
+    char            *rt_buf;    /* pixels de la cible interne (NULL = alias de l'écran) */
+    int             *xs;        /* colonne source de chaque colonne écran */
+    int             *ys;        /* ligne source de chaque ligne écran */
+    t_upscale_fn    upscale;
+    bool            report;
+    t_drs_stats     last;
+}   t_drs;
+
+/* Une frame vue par le profileur: temps par étape + intervalle depuis la
+** frame précédente (rythme réel, pauses comprises). */
+typedef struct s_prof_frame
+{
+    long long   ns[PROF_COUNT];
+    long long   frame_ns;
+    long long   pmu[PROF_COUNT][PMU_COUNT]; /* compteurs, tous workers (-1 = absent) */
+    long long   pixels;     /* taille de la cible de rendu */
+}   t_prof_frame;
+
+/* Compteurs d'un worker: ouverts par le worker lui-même (pid 0 = thread
+** appelant) à sa première tuile, lus en un seul read() groupé. */
+typedef struct s_pmu
+{
+    int         leader;     /* fd du groupe (-2 = pas encore ouvert, -1 = échec) */
+    int         fd[PMU_COUNT];
+    int         slot[PMU_COUNT]; /* position dans la lecture groupée (-1 = absent) */
+    int         nr;
+    long long   start[PMU_COUNT];
+    long long   acc[PROF_COUNT][PMU_COUNT];
+    char        pad[64];    /* pas de partage de ligne entre workers voisins */
+}   t_pmu;
+
+typedef struct s_prof
+{
+    t_prof_frame    ring[PROF_RING];
+    int             head;       /* prochaine case écrite */
+    int             count;      /* frames valides dans l'anneau */
+    t_prof_frame    cur;        /* frame en cours d'accumulation */
+    long long       t0[PROF_COUNT]; /* début de l'étape ouverte (0 = aucune) */
+    long long       last_ns;    /* fin de la frame précédente */
+    bool            overlay;
+    int             stage;      /* étape ouverte, lue par les workers */
+    t_pmu           *pmu;       /* un par worker (NULL = compteurs désactivés) */
+    int             npmu;
+}   t_prof;
+
+/* Un événement de trace: début ('B') ou fin ('E') d'une zone. */
+typedef struct s_trace_ev
+{
+    long long   ts;         /* ns depuis trace_init */
+    const char  *name;      /* chaîne statique */
+    int         x0;         /* tuiles: colonnes [x0, x1), sinon -1 */
+    int         x1;
+    char        ph;
+}   t_trace_ev;
+
+/* Tampons d'un thread: un seul écrivain (le worker) dans ev; entre deux
+** frames, quand tous les workers sont au repos, le thread principal
+** échange ev et out et confie out au thread d'écriture (aucun verrou sur
+** le chemin chaud). Une zone refusée faute de place l'est avec tout ce
+** qu'elle contient, fin comprise: jamais de 'B' sans son 'E'. */
+typedef struct s_trace_buf
+{
+    t_trace_ev  *ev;
+    t_trace_ev  *out;       /* tampon en cours d'écriture (out_n événements) */
+    int         n;
+    int         out_n;
+    int         dropped;    /* événements perdus (tampon plein) */
+    int         depth;      /* zones ouvertes, acceptées ou non */
+    int         skip;       /* profondeur de la première zone refusée, 0 si aucune */
+    char        pad[64 - 2 * sizeof(t_trace_ev *) - 5 * sizeof(int)];
+}   t_trace_buf;
+
+typedef struct s_trace
+{
+    void            *f;         /* FILE* du fichier de trace (NULL = inactif) */
+    t_trace_buf     *bufs;      /* un par worker, index = worker */
+    int             nbufs;
+    int             written;    /* événements déjà écrits (virgules JSON) */
+    long long       t0;
+    pthread_t       writer;     /* écrit les tampons out hors de la boucle */
+    pthread_mutex_t mu;
+    pthread_cond_t  cv;
+    bool            writer_on;
+    bool            pending;    /* tampons out confiés au thread d'écriture */
+    bool            stop;
+    unsigned int    open;       /* étapes PROF_* ouvertes sur le thread principal */
+}   t_trace;
+
+/* Les étapes PROF_* alimentent le profileur (PROFILE=1) et/ou la trace
+** (TRACE=1); sans l'un ni l'autre, aucun code n'est généré. */
+# if defined(POKE3D_PROFILE) || defined(POKE3D_TRACE)
+#  define PROF_BEGIN(g, id)    prof_begin((g), (id))
+#  define PROF_END(g, id)      prof_end((g), (id))
+# else
+#  define PROF_BEGIN(g, id)    ((void)0)
+#  define PROF_END(g, id)      ((void)0)
+# endif
+# ifdef POKE3D_PROFILE
+#  define PROF_INIT(g)         prof_init(g)
+#  define PROF_REPORT(g)       prof_report(g)
+#  define PROF_FREE(g)         pmu_close(g)
+#  define PROF_FRAME_END(g)    prof_frame_end(g)
+#  define PROF_OVERLAY(g)      prof_overlay(g)
+#  define PROF_TILE_BEGIN(g, w) do { if ((g)->prof.pmu) pmu_begin((g), (w)); } while (0)
+#  define PROF_TILE_END(g, w)  do { if ((g)->prof.pmu) pmu_end((g), (w)); } while (0)
+# else
+#  define PROF_INIT(g)         ((void)0)
+#  define PROF_REPORT(g)       ((void)0)
+#  define PROF_FREE(g)         ((void)0)
+#  define PROF_FRAME_END(g)    ((void)0)
+#  define PROF_OVERLAY(g)      ((void)0)
+#  define PROF_TILE_BEGIN(g, w) ((void)0)
+#  define PROF_TILE_END(g, w)  ((void)0)
+# endif
+# ifdef POKE3D_TRACE
+#  define TRACE_INIT(g)        trace_init(g)
+#  define TRACE_CLOSE(g)       trace_close(&(g)->trace)
+#  define TRACE_FLUSH(g)       trace_flush(&(g)->trace, false)
+#  define TRACE_BEGIN(g, w, name, x0, x1) \
+    trace_event(&(g)->trace, (w), (name), 'B', (x0), (x1))
+#  define TRACE_END(g, w, name) trace_event(&(g)->trace, (w), (name), 'E', -1, -1)
+# else
+#  define TRACE_INIT(g)        ((void)0)
+#  define TRACE_CLOSE(g)       ((void)0)
+#  define TRACE_FLUSH(g)       ((void)0)
+#  define TRACE_BEGIN(g, w, name, x0, x1) ((void)0)
+#  define TRACE_END(g, w, name) ((void)0)
+# endif
+
+/* Résultats des rayons en structure-de-tableaux (une entrée par colonne),
+** remplis par paquets par le traverseur DDA et consommés en bloc par le
+** texturage. side = 0 si impact sur une face verticale, 1 si horizontale. */
+typedef struct s_hits
+{
+    float   *ray_dir_x;
+    float   *ray_dir_y;
+    float   *perp_dist;     /* distance perpendiculaire (anti fish-eye) */
+    float   *wall_x;        /* position d'impact le long du mur [0..1) */
+    int     *map_x;         /* case touchée */
+    int     *map_y;
+    int     *side;
+    int     *line_h;        /* hauteur de la bande mur (non bornée) */
+    int     *draw_start;    /* première/dernière ligne du mur, bornées à l'écran */
+    int     *draw_end;
+    int     count;
+}   t_hits;
+
+/* Sprite visible pour la frame: projeté, borné à l'écran, trié du plus
+** loin au plus proche (peintre). */
+typedef struct s_sprite_vis
+{
+    float   depth;      /* profondeur caméra (comparée à zbuf) */
+    int     left;       /* colonne écran du bord gauche (non bornée) */
+    int     size;       /* côté du billboard en pixels */
+    int     x0;         /* colonnes [x0, x1) bornées à l'écran */
+    int     x1;
+    int     y0;         /* lignes [y0, y1) non bornées (pied posé au sol) */
+    int     y1;
+}   t_sprite_vis;
+
+/* Texels opaques d'une texture de sprite, par colonne: les paires
+** run[2k] / run[2k+1] = lignes [début, fin) des segments opaques de la
+** colonne c, pour k dans [first[c], first[c + 1]). Construit au chargement;
+** le blitter copie ces segments et ne lit jamais un texel transparent. */
+typedef struct s_sprite_runs
+{
+    int     *first;     /* w + 1 indices de segment */
+    int     *run;       /* 2 entiers par segment */
+    int     w;
+    int     h;
+}   t_sprite_runs;
+
+/* Index spatial des sprites: une liste doublement chaînée d'ids par seau
+** de 2^SGRID_SHIFT × 2^SGRID_SHIFT cases (maillons next/prev dans
+** t_sprite). Retrait en O(1) quand un sprite est ramassé; les requêtes ne
+** visitent que les seaux utiles. Une tête par seau et non par case: 6 Mo
+** au lieu de 400 pour une carte de 10000², que les sprites soient
+** groupés ou non. */
+# define SGRID_SHIFT 3
+
+typedef struct s_sprite_grid
+{
+    int     *head;      /* w × h seaux: premier sprite du seau + 1, 0 si vide */
+    int     *found;     /* ids renvoyés par la dernière requête (sprite_count) */
+    int     w;          /* seaux par ligne: map_w arrondi au seau supérieur */
+    int     h;
+}   t_sprite_grid;
+
+/* Dessin des sprites: segments opaques (défaut) ou test de clé par texel
+** (référence pour le bench) */
+# define SPRITE_RUNS  0
+# define SPRITE_KEYED 1
+
+struct s_game;
+
+/* Traverseur DDA: remplit h pour les colonnes [x0, x1). */
+typedef void (*t_trace_fn)(const struct s_game *g, const t_view *v,
+                           int x0, int x1, t_hits *h);
+
+/* Paramètres du sol pré-calculés par ligne d'écran (ne dépendent que de y).
+** Coordonnées monde en virgule fixe 16.16: la partie basse donne
+** directement la fraction dans la tuile de sol. */
+typedef struct s_floor_rows
+{
+    unsigned int    *base_x;    /* position monde au bord gauche de la ligne */
+    unsigned int    *base_y;
+    int             *step_x;    /* pas monde par colonne d'écran */
+    int             *step_y;
+    int             *shade;     /* assombrissement 0..256 (256 = intact) */
+    int             count;
+}   t_floor_rows;
+
+/* Tables du ciel: tx par colonne (angle du rayon -> colonne de texture),
+** reconstruite seulement quand la caméra tourne ou que la taille change;
+** ty par ligne (hauteur écran -> ligne de texture), construite une fois. */
+typedef struct s_sky_lut
+{
+    int     *tx;        /* colonne de texture SANS défilement, dans [0, tex_w) */
+    int     *ty;        /* ligne de texture pour chaque ligne d'écran */
+    t_v2f   dir;        /* caméra pour laquelle tx est valide */
+    t_v2f   plane;
+    int     tx_w;       /* largeur écran / texture pour lesquelles tx est valide */
+    int     tx_tw;
+    int     ty_h;       /* hauteur écran / texture pour lesquelles ty est valide */
+    int     ty_th;
+}   t_sky_lut;
+
+/* Noyau de transposition d'un bloc 8x8 (colonnes de src -> lignes de dst). */
+typedef void (*t_tr_fn)(const unsigned int *src, int sstride,
+                        unsigned int *dst, int dstride);
+
+/* Passe de rendu: traite les colonnes [x0, x1) d'un étage du pipeline. */
+typedef void (*t_stage_fn)(struct s_game *g, int x0, int x1);
+
+/* Backend d'affichage: tout ce qui touche à X / MiniLibX passe par ici.
+** g_backend_mlx ouvre une fenêtre; g_backend_mem rend dans un buffer
+** aligné en mémoire, sans connexion X (CI, nœuds de rendu, benchmarks).
+** Le rendu lui-même (render_scene) est identique pour les deux. */
+typedef struct s_backend
+{
+    const char  *name;
+    int         (*init)(struct s_game *g);      /* connexion + fenêtre win_w × win_h */
+    int         (*screen_new)(struct s_game *g, int w, int h);  /* remplit g->screen */
+    void        (*screen_free)(struct s_game *g);
+    int         (*tex_load)(struct s_game *g, t_tex *t, const char *path);
+    void        (*tex_free)(struct s_game *g, t_tex *t);
+    void        (*present)(struct s_game *g);   /* affiche g->screen */
+    int         (*resize)(struct s_game *g, int w, int h);  /* fenêtre seule */
+    void        (*run)(struct s_game *g);       /* boucle principale */
+    void        (*shutdown)(struct s_game *g);
+}   t_backend;
+
+extern const t_backend  g_backend_mlx;
+extern const t_backend  g_backend_mem;
+
 /* Contexte global du jeu. */
 typedef struct s_game
 {
+    const t_backend *be;    /* backend d'affichage (MLX ou mémoire) */
     void        *mlx;
     void        *win;
+    bool        headless;   /* --headless: backend mémoire */
+    int         run_frames; /* headless: frames à rendre avant de quitter */
+    const char  *out_path;  /* headless: dernière frame écrite ici (.ppm ou brut) */
+    const char  *map_path;  /* --map FICHIER (sinon la petite carte codée en dur) */
+    const char  *world_path;    /* --world FICHIER: monde en chunks (world.c) */
+    const char  *save_world;    /* --save-world FICHIER: écrit la carte en monde et quitte */
+    int         presented;  /* frames présentées (les deux backends) */
 
-    /* Framebuffer: on dessine ici chaque image puis on "push" vers la fenêtre. */
+    /* Taille de la fenêtre et champ de vision effectifs (config / CLI) */
+    int         win_w;
+    int         win_h;
+    float       fov;
+    int         want_w;     /* redimensionnement demandé (appliqué entre deux frames) */
+    int         want_h;
+
+    /* screen = image MLX de la taille de la fenêtre (ce qu'on "push");
+    ** frame = cible de rendu interne, éventuellement réduite par le
+    ** gouverneur de résolution (alias de screen à 100 %). */
+    t_img       screen;
     t_img       frame;
+    t_drs       drs;
+# ifdef POKE3D_PROFILE
+    t_prof      prof;       /* temps par étape (make PROFILE=1) */
+# endif
+# ifdef POKE3D_TRACE
+    t_trace     trace;      /* trace Chrome (make TRACE=1, POKE3D_TRACE=fichier) */
+# endif
+    int         fb_mode;    /* FB_DIRECT ou FB_TRANSPOSED */
+    t_img       colfb;      /* buffer column-major du mode transposé (px, line_len = pixels/colonne) */
+    t_tr_fn     tr_block;
+    const char  *tr_name;
 
     /* Textures (au minimum un mur). Vous pouvez en ajouter d'autres. */
     t_tex       tex_wall;
     t_tex       tex_sky;     /* optionnel: simple bandeau pour le ciel */
     t_tex       tex_floor;   /* optionnel: couleur/texture pour le sol */
 
-    /* Carte: tableau de chaînes "0"/"1".
-    ** map_h = nombre de lignes; map_w = nombre de colonnes (rectangulaire). */
-    char        **map;
+    /* Carte: map_h lignes, map_w colonnes (la plus longue ligne chargée).
+    ** Les chaînes "0"/"1"/"C" ne servent qu'au chargement (map_load_rows). */
     int         map_w;
     int         map_h;
+    t_grid      grid;
+    t_spawn     *spawns;    /* départs du fichier de carte (map_load_file) */
+    int         spawn_count;
+    t_world     world;      /* fenêtre du monde en chunks (active avec --world) */
 
     int         tick; /* NEW: compteur simple pour des effets (parallaxe ciel) */
-    
+    int         sky_off;    /* décalage courant du ciel (texels), cadence SKY_SCROLL_MS */
+    long long   sky_t0_ms;  /* origine de temps du défilement */
+    unsigned int dirty;     /* bits DIRTY_*: ce qui a changé depuis la dernière frame */
+
+    /* Rendu multithread: pool de workers + caméra figée pour la frame. */
+    t_pool      pool;
+    t_sched     sched;
+    t_view      view;
+
+    /* Traversée DDA par paquets (choisie selon le CPU) + impacts de la frame */
+    t_trace_fn  dda;
+    const char  *dda_name;
+    int         dda_skip;   /* DDA_SKIP_*: sauts d'espace vide (POKE3D_SKIP) */
+    t_hits      hits;
+    t_floor_rows floor_rows;
+    t_sky_lut   sky;
+
+    /* Sprites visibles de la frame (projetés puis triés par sprites_project) */
+    t_sprite_vis *svis;
+    int         svis_count;
+    int         sprite_mode;    /* SPRITE_RUNS ou SPRITE_KEYED */
+    t_sprite_grid sgrid;        /* ids des sprites actifs par seau de cases */
+
     /* Joueur + état des touches */
     t_player    p;
     t_keys      keys;
@@ -125,17 +825,37 @@ typedef struct s_sprite {
     float x;         /* position monde (centre de case) */
     float y;
     bool  active;    /* true tant que pas ramassé */
+    int   next;      /* maillons de la liste de son seau (t_sprite_grid), -1 = fin */
+    int   prev;
 }   t_sprite;
 
-t_tex      tex_pokeball;        /* sprite pokeball (transparence par clé couleur) */
-t_tex      tex_pokeball_small;  /* petite pokeball pour le HUD (ou fallback) */
+/* Déclarés ici, définis une seule fois dans main.c (plusieurs .c incluent ce header). */
+extern t_tex      tex_pokeball;        /* sprite pokeball (transparence par clé couleur) */
+extern t_tex      tex_pokeball_small;  /* petite pokeball pour le HUD (ou fallback) */
+extern t_sprite_runs pokeball_runs;    /* segments opaques de tex_pokeball */
 
-t_sprite  *sprites;      /* tableau dynamique de sprites détectés dans la map */
-int        sprite_count; /* combien au total */
+extern t_sprite  *sprites;      /* tableau dynamique de sprites détectés dans la map */
+extern int        sprite_count; /* combien au total */
 
-int        collected;    /* combien ramassées (pour le HUD) */
+extern int        collected;    /* combien ramassées (pour le HUD) */
 
-float     *zbuf;         /* z-buffer par colonne: distance perpendicular du mur pour occlusion sprites */
+extern float     *zbuf;         /* z-buffer par colonne: distance perpendicular du mur pour occlusion sprites
+                                   (= hits.perp_dist, à la largeur de la cible de rendu) */
+
+void    sprites_load(t_game *g, const char *const *rows);
+void    sprites_reserve(t_game *g, int n);
+void    sprites_free(t_game *g);
+void    sprites_project(t_game *g);
+void    sprite_pickup(t_game *g);
+void    stage_sprites(t_game *g, int x0, int x1);
+int     tex_sprite_procedural(t_tex *t, int size);
+int     sprite_runs_build(t_sprite_runs *r, const t_tex *t);
+void    sprite_runs_free(t_sprite_runs *r);
+int     sgrid_build(t_game *g);
+void    sgrid_free(t_game *g);
+void    sgrid_remove(t_game *g, int id);
+int     sgrid_query_wedge(t_game *g, const t_view *v);
+int     sgrid_query_near(t_game *g, t_v2f p);
 
 
 /* =============================
@@ -146,11 +866,23 @@ void    panic(const char *msg);
 
 int     create_frame(t_game *g, int w, int h);
 void    destroy_frame(t_game *g);
+int     game_resize(t_game *g, int w, int h);
+
+void    config_defaults(t_game *g);
+int     config_load(t_game *g, const char *path);
+int     config_args(t_game *g, int argc, char **argv);
+void    game_set_fov(t_game *g, float fov);
 void    put_pixel(t_img *img, int x, int y, int color);
 int     rgb(int r, int g, int b);
+long long clock_ns(void);
 
 int     load_xpm(t_game *g, t_tex *dst, const char *path);
+int     try_load_xpm_paths(t_game *g, t_tex *dst, const char *file);
 void    destroy_tex(t_game *g, t_tex *t);
+int     tex_apply_layout(t_tex *t);
+int     tex_procedural(t_tex *t, int w, int h, int seed);
+int     xpm_load(t_tex *t, const char *path);
+int     screen_write(const t_game *g, const char *path);
 
 /* =============================
 **  Prototypes (entrée / hooks)
@@ -158,17 +890,109 @@ void    destroy_tex(t_game *g, t_tex *t);
 int     key_press(int keycode, t_game *g);
 int     key_release(int keycode, t_game *g);
 int     loop_hook(t_game *g);
+int     on_expose(t_game *g);
+void    loop_start(t_game *g);
 
 /* =============================
 **  Prototypes (rendu / DDA)
 ** ============================= */
 void    render_frame(t_game *g);
-void    cast_column(t_game *g, int x);
+void    render_invalidate(t_game *g, unsigned int flags);
+void    render_scene(t_game *g);
+int     render_alloc(t_game *g, int w, int h);
+void    render_free(t_game *g);
+void    floor_rows_update(t_game *g);
+void    sky_lut_update(t_game *g);
+void    view_update(t_game *g);
+void    render_pass(t_game *g, t_stage_fn fn);
+void    stage_hits(t_game *g, int x0, int x1);
+void    stage_sky(t_game *g, int x0, int x1);
+void    stage_floor(t_game *g, int x0, int x1);
+void    stage_walls(t_game *g, int x0, int x1);
+void    stage_transpose(t_game *g, int x0, int x1);
+
+int     fb_mode_from_env(void);
+int     colfb_ensure(t_game *g);
+void    colfb_free(t_game *g);
+void    transpose_select(t_game *g);
+
+int     img_rows_build(t_img *img, unsigned int *base, int xstep, int ystep);
+void    img_rows_free(t_img *img);
+void    span_copy_v(t_img *img, int x, int y0, int y1, const t_span_src *src);
+void    span_fill_h(t_img *img, int y, int x0, int x1, int color);
+
+void    drs_init(t_game *g);
+int     rt_resize(t_game *g, int w, int h);
+int     rt_fit(t_game *g);
+void    rt_free(t_game *g);
+void    rt_upscale(t_game *g);
+void    drs_update(t_game *g, long long frame_ns);
+const t_drs_stats *drs_stats(const t_game *g);
+
+void    prof_init(t_game *g);
+void    prof_begin(t_game *g, int id);
+void    prof_end(t_game *g, int id);
+void    prof_frame_end(t_game *g);
+const t_prof_frame *prof_last(const t_game *g);
+void    prof_overlay(t_game *g);
+void    prof_report(const t_game *g);
+
+void    pmu_init(t_game *g);
+void    pmu_begin(t_game *g, int worker);
+void    pmu_end(t_game *g, int worker);
+void    pmu_collect(t_game *g, t_prof_frame *f);
+void    pmu_close(t_game *g);
+
+void    trace_init(t_game *g);
+void    trace_event(t_trace *t, int worker, const char *name, char ph, int x0, int x1);
+void    trace_flush(t_trace *t, bool force);
+void    trace_close(t_trace *t);
+
+bool    is_wall(const t_game *g, int mx, int my);
+void    df_build(t_grid *gr, int w, int h);
+void    df_update(t_grid *gr, int w, int h, int x, int y);
+int     mip_build(t_grid *gr, int h);
+void    mip_update(t_grid *gr, int x, int y);
+void    mip_update_rect(t_grid *gr, int x0, int y0, int x1, int y1);
+void    mip_free(t_grid *gr);
+int     mip_block(const t_grid *gr, int x, int y, int stx, int sty, int lv,
+                  int *ax, int *ay);
+void    dda_jump(float sx0, float dx, float sy0, float dy, int ax, int ay,
+                 int *nx, int *ny);
+int     hits_alloc(t_hits *h, int count);
+void    hits_free(t_hits *h);
+void    dda_select(t_game *g);
+
+/* =============================
+**  Prototypes (threads)
+** ============================= */
+int     pool_init(t_pool *pool, int count);
+void    pool_run(t_pool *pool, t_job job, void *arg);
+void    pool_destroy(t_pool *pool);
+int     render_thread_count(void);
+
+int     sched_init(t_sched *s, int nworkers, int width, int tile_w);
+void    sched_run(t_sched *s, t_pool *pool, t_tile_fn fn, void *arg);
+void    sched_destroy(t_sched *s);
+const t_sched_stats *sched_stats(const t_sched *s);
+int     sched_tile_width(void);
 
 /* =============================
 **  Prototypes (setup)
 ** ============================= */
 void    setup_player(t_game *g, float px, float py, float dir_deg);
 void    setup_map_small(t_game *g);
+void    map_load_rows(t_game *g, const char *const *rows);
+int     map_load_file(t_game *g, const char *path, t_map_stats *st);
+int     grid_alloc(t_grid *gr, int w, int h);
+int     grid_derive(t_grid *gr, int w, int h);
+void    map_set_cell(t_game *g, int x, int y, char c);
+int     world_open(t_game *g, const char *path);
+void    world_update(t_game *g);
+void    world_close(t_game *g);
+int     world_write(const char *path, const t_spawn *spawn, int cw, int ch,
+                    t_world_gen gen, void *ctx);
+int     world_save(t_game *g, const char *path);
+void    map_free(t_game *g);
 
 #endif
@@ -0,0 +1,140 @@
+#include "game.h"
+#include <stdio.h>    /* fopen(), fwrite(), printf() */
+
+/* ==========================================================================
+**  Backend mémoire (sans affichage)
+**  --------------------------------------------------------------------------
+**  Aucun appel à X: l'écran est un buffer 32 bits aligné sur 64 octets,
+**  les XPM sont lus par xpm_load, present ne fait que compter. La boucle
+**  appelle loop_hook, exactement comme mlx_loop, avec la rotation "tenue"
+**  pour que chaque itération rende une frame; puis la dernière frame est
+**  écrite sur disque si --out est donné. Le gouverneur de résolution est
+**  éteint (drs_init) sauf POKE3D_FRAME_MS: la taille de rendu, donc la
+**  sortie, ne dépend pas de la vitesse de la machine.
+**
+**  screen_write : écrit g->screen en PPM (P6, extension .ppm) ou brut
+**                 (pixels 32 bits 0x00RRGGBB, ligne après ligne)
+** ========================================================================== */
+
+static int  mem_init(t_game *g)
+{
+    (void)g;
+    return (1);
+}
+
+static int  mem_screen_new(t_game *g, int w, int h)
+{
+    g->screen.w = w;
+    g->screen.h = h;
+    g->screen.bpp = 32;
+    g->screen.line_len = w * 4;
+    g->screen.endian = 0;
+    if (posix_memalign((void **)&g->screen.addr, 64, (size_t)w * h * 4))
+    {
+        g->screen.addr = NULL;
+        return (0);
+    }
+    __builtin_memset(g->screen.addr, 0, (size_t)w * h * 4);
+    return (1);
+}
+
+static void mem_screen_free(t_game *g)
+{
+    free(g->screen.addr);
+}
+
+static int  mem_tex_load(t_game *g, t_tex *t, const char *path)
+{
+    (void)g;
+    return (xpm_load(t, path));
+}
+
+static void mem_tex_free(t_game *g, t_tex *t)
+{
+    (void)g;
+    free(t->addr);
+}
+
+static void mem_present(t_game *g)
+{
+    g->presented++;
+}
+
+static int  mem_resize(t_game *g, int w, int h)
+{
+    (void)g;
+    (void)w;
+    (void)h;
+    return (1);
+}
+
+static void mem_run(t_game *g)
+{
+    long long   t0;
+    long long   total;
+    int         n;
+
+    n = (g->run_frames > 0) ? g->run_frames : HEADLESS_FRAMES;
+    g->keys.right = true;
+    g->presented = 0;
+    t0 = clock_ns();
+    while (g->presented < n)
+        loop_hook(g);
+    total = clock_ns() - t0;
+    printf("headless: %d frames %dx%d (render %dx%d), %.3f ms/frame, %s dda, %d thread(s)\n",
+           n, g->screen.w, g->screen.h, g->frame.w, g->frame.h,
+           total / 1e6 / n, g->dda_name, g->pool.count);
+    if (g->out_path && !screen_write(g, g->out_path))
+        panic("headless: cannot write output frame");
+}
+
+static void mem_shutdown(t_game *g)
+{
+    (void)g;
+}
+
+const t_backend g_backend_mem = {
+    "mem", mem_init, mem_screen_new, mem_screen_free, mem_tex_load,
+    mem_tex_free, mem_present, mem_resize, mem_run, mem_shutdown
+};
+
+int     screen_write(const t_game *g, const char *path)
+{
+    const t_img     *s = &g->screen;
+    size_t          n = strlen(path);
+    unsigned char   *rgb;
+    FILE            *f;
+    int             ok;
+    int             x;
+    int             y;
+
+    f = fopen(path, "wb");
+    if (!f)
+        return (0);
+    ok = 1;
+    if (n < 4 || strcmp(path + n - 4, ".ppm"))
+    {
+        y = 0;
+        while (ok && y < s->h)
+            ok = (fwrite(s->rows[y++], 4, s->w, f) == (size_t)s->w);
+        return ((fclose(f) == 0) && ok);
+    }
+    rgb = (unsigned char *)malloc((size_t)s->w * 3);
+    ok = (rgb && fprintf(f, "P6\n%d %d\n255\n", s->w, s->h) > 0);
+    y = 0;
+    while (ok && y < s->h)
+    {
+        x = 0;
+        while (x < s->w)
+        {
+            rgb[x * 3] = (unsigned char)(s->rows[y][x] >> 16);
+            rgb[x * 3 + 1] = (unsigned char)(s->rows[y][x] >> 8);
+            rgb[x * 3 + 2] = (unsigned char)s->rows[y][x];
+            x++;
+        }
+        ok = (fwrite(rgb, 3, s->w, f) == (size_t)s->w);
+        y++;
+    }
+    free(rgb);
+    return ((fclose(f) == 0) && ok);
+}
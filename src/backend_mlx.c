@@ -0,0 +1,122 @@
+#include "game.h"
+
+/* ==========================================================================
+**  Backend MiniLibX (fenêtre X11)
+**  --------------------------------------------------------------------------
+**  mlxbe_init       : connexion X + fenêtre win_w × win_h
+**  mlxbe_screen_new : image MLX de la fenêtre (g->screen)
+**  mlxbe_tex_load   : XPM via mlx_xpm_file_to_image
+**  mlxbe_present    : affiche g->screen dans la fenêtre
+**  mlxbe_resize     : recrée la fenêtre (MiniLibX la fige à la création)
+**  mlxbe_run        : hooks clavier / Expose / fermeture, puis mlx_loop
+**  mlxbe_shutdown   : détruit fenêtre et display
+** ========================================================================== */
+
+static void hooks_install(t_game *g)
+{
+    /* - DestroyNotify: fermeture de la fenêtre
+       - KeyPress/KeyRelease: gestion des entrées clavier
+       - Expose: ré-affichage de l'image quand la fenêtre redevient visible */
+    mlx_hook(g->win, DestroyNotify, StructureNotifyMask, close_window, g);
+    mlx_hook(g->win, KeyPress, KeyPressMask, key_press, g);
+    mlx_hook(g->win, KeyRelease, KeyReleaseMask, key_release, g);
+    mlx_expose_hook(g->win, on_expose, g);
+}
+
+static int  mlxbe_init(t_game *g)
+{
+    /* Initialisation MLX : ouvre une connexion au serveur X */
+    g->mlx = mlx_init();
+    if (!g->mlx)
+        return (0);
+    /* Crée une fenêtre de taille win_w × win_h avec un titre */
+    g->win = mlx_new_window(g->mlx, g->win_w, g->win_h, "poke3DDA engine");
+    return (g->win != NULL);
+}
+
+static int  mlxbe_screen_new(t_game *g, int w, int h)
+{
+    g->screen.w = w;
+    g->screen.h = h;
+    g->screen.img = mlx_new_image(g->mlx, w, h);
+    if (!g->screen.img)
+        return (0);
+    g->screen.addr = mlx_get_data_addr(g->screen.img, &g->screen.bpp,
+                                       &g->screen.line_len, &g->screen.endian);
+    return (g->screen.addr != NULL);
+}
+
+static void mlxbe_screen_free(t_game *g)
+{
+    if (g->screen.img)
+        mlx_destroy_image(g->mlx, g->screen.img);
+    g->screen.img = NULL;
+}
+
+/* - mlx_xpm_file_to_image remplit t->w et t->h (dimensions)
+   - mlx_get_data_addr permet d'accéder aux pixels (addr/bpp/stride/endian) */
+static int  mlxbe_tex_load(t_game *g, t_tex *t, const char *path)
+{
+    t->img = mlx_xpm_file_to_image(g->mlx, (char *)path, &t->w, &t->h);
+    if (!t->img)
+        return (0);
+    t->addr = mlx_get_data_addr(t->img, &t->bpp, &t->line_len, &t->endian);
+    return (t->addr != NULL);
+}
+
+static void mlxbe_tex_free(t_game *g, t_tex *t)
+{
+    if (t->img)
+        mlx_destroy_image(g->mlx, t->img);
+    t->img = NULL;
+}
+
+static void mlxbe_present(t_game *g)
+{
+    /* Affiche l'image de la fenêtre à la position (0,0) */
+    mlx_put_image_to_window(g->mlx, g->win, g->screen.img, 0, 0);
+    g->presented++;
+}
+
+/* Appelé depuis loop_hook, jamais pendant la distribution des événements */
+static int  mlxbe_resize(t_game *g, int w, int h)
+{
+    void    *win;
+
+    win = mlx_new_window(g->mlx, w, h, "poke3DDA engine");
+    if (!win)
+        return (0);
+    if (g->win)
+        mlx_destroy_window(g->mlx, g->win);
+    g->win = win;
+    hooks_install(g);
+    __builtin_memset(&g->keys, 0, sizeof(g->keys)); /* relâchements perdus */
+    return (1);
+}
+
+static void mlxbe_run(t_game *g)
+{
+    /* Hooks de la fenêtre + loop_hook, appelé en boucle chaque “frame” */
+    hooks_install(g);
+    mlx_loop_hook(g->mlx, loop_hook, g);
+    /* Boucle événementielle MLX (ne retourne pas avant la fermeture) */
+    mlx_loop(g->mlx);
+}
+
+static void mlxbe_shutdown(t_game *g)
+{
+    if (g->win)
+        mlx_destroy_window(g->mlx, g->win);
+    g->win = NULL;
+    if (g->mlx)
+    {
+        mlx_destroy_display(g->mlx);
+        free(g->mlx);
+    }
+    g->mlx = NULL;
+}
+
+const t_backend g_backend_mlx = {
+    "mlx", mlxbe_init, mlxbe_screen_new, mlxbe_screen_free, mlxbe_tex_load,
+    mlxbe_tex_free, mlxbe_present, mlxbe_resize, mlxbe_run, mlxbe_shutdown
+};
@@ -0,0 +1,165 @@
+#include "game.h"
+#include <stdio.h>    /* fopen(), fgets(), sscanf(), fprintf() */
+
+/* ==========================================================================
+**  Configuration — résolution et FOV à l'exécution
+**  --------------------------------------------------------------------------
+**  WIN_W, WIN_H et FOV ne sont plus que des valeurs par défaut: la taille
+**  de la fenêtre et le champ de vision vivent dans t_game (win_w, win_h,
+**  fov). Ordre de priorité: défauts < fichier de config < ligne de commande.
+**
+**  config_defaults : WIN_W × WIN_H, FOV
+**  config_load     : lit un fichier "clé = valeur" (width, height, fov, '#')
+**  config_args     : --config F (tous lus avant les autres options),
+**                    --size WxH, --width W, --height H, --fov DEG,
+**                    --headless, --frames N, --out FICHIER (mode sans affichage),
+**                    --map FICHIER (carte .ber, voir map_file.c),
+**                    --world FICHIER (monde en chunks, voir world.c),
+**                    --save-world FICHIER (écrit la carte en monde)
+**  game_set_fov    : change le FOV en gardant la direction du regard
+** ========================================================================== */
+
+void    config_defaults(t_game *g)
+{
+    const char  *env = getenv("POKE3D_BACKEND");
+
+    g->win_w = WIN_W;
+    g->win_h = WIN_H;
+    g->fov = FOV;
+    g->headless = (env && !strcmp(env, "headless"));
+    g->run_frames = HEADLESS_FRAMES;
+}
+
+/* Bornes raisonnables: une valeur hors bornes est une erreur de config */
+static int  config_set(t_game *g, const char *key, double v)
+{
+    if (!strcmp(key, "width") && v >= RES_MIN && v <= RES_MAX)
+        g->win_w = (int)v;
+    else if (!strcmp(key, "height") && v >= RES_MIN && v <= RES_MAX)
+        g->win_h = (int)v;
+    else if (!strcmp(key, "fov") && v >= FOV_MIN && v <= FOV_MAX)
+        g->fov = (float)v;
+    else
+        return (0);
+    return (1);
+}
+
+int     config_load(t_game *g, const char *path)
+{
+    FILE    *f;
+    char    line[256];
+    char    key[32];
+    double  v;
+    int     n;
+    int     ok;
+
+    f = fopen(path, "r");
+    if (!f)
+        return (0);
+    ok = 1;
+    n = 0;
+    while (fgets(line, sizeof(line), f))
+    {
+        n++;
+        if (sscanf(line, " %31[#]", key) == 1 || sscanf(line, " %31s", key) != 1)
+            continue ; /* commentaire ou ligne vide */
+        if (sscanf(line, " %31[a-z_] = %lf", key, &v) != 2 || !config_set(g, key, v))
+        {
+            fprintf(stderr, "poke3d: %s:%d: invalid setting\n", path, n);
+            ok = 0;
+        }
+    }
+    fclose(f);
+    return (ok);
+}
+
+/* Pré-passe: tous les --config d'abord, où qu'ils soient dans argv, pour
+   que les autres options de la ligne de commande l'emportent toujours */
+static int  config_files(t_game *g, int argc, char **argv)
+{
+    int i;
+
+    i = 1;
+    while (i < argc)
+    {
+        if (!strcmp(argv[i], "--headless"))
+        {
+            i++;
+            continue ;
+        }
+        if (i + 1 < argc && !strcmp(argv[i], "--config")
+            && !config_load(g, argv[i + 1]))
+            return (0);
+        i += 2;
+    }
+    return (1);
+}
+
+int     config_args(t_game *g, int argc, char **argv)
+{
+    int i;
+    int w;
+    int h;
+
+    if (!config_files(g, argc, argv))
+        return (0);
+    i = 1;
+    while (i < argc)
+    {
+        if (!strcmp(argv[i], "--headless"))
+        {
+            g->headless = true;
+            i++;
+            continue ;
+        }
+        if (i + 1 >= argc)
+            return (0);
+        if (!strcmp(argv[i], "--config"))
+        {
+            i += 2;     /* déjà lu par config_files */
+            continue ;
+        }
+        if (!strcmp(argv[i], "--frames"))
+        {
+            g->run_frames = atoi(argv[i + 1]);
+            if (g->run_frames < 1)
+                return (0);
+        }
+        else if (!strcmp(argv[i], "--out"))
+            g->out_path = argv[i + 1];
+        else if (!strcmp(argv[i], "--map"))
+            g->map_path = argv[i + 1];
+        else if (!strcmp(argv[i], "--world"))
+            g->world_path = argv[i + 1];
+        else if (!strcmp(argv[i], "--save-world"))
+            g->save_world = argv[i + 1];
+        else if (!strcmp(argv[i], "--size"))
+        {
+            if (sscanf(argv[i + 1], "%dx%d", &w, &h) != 2
+                || !config_set(g, "width", w) || !config_set(g, "height", h))
+                return (0);
+        }
+        else if (!strncmp(argv[i], "--", 2))
+        {
+            if (!config_set(g, argv[i] + 2, strtod(argv[i + 1], NULL)))
+                return (0);
+        }
+        else
+            return (0);
+        i += 2;
+    }
+    return (1);
+}
+
+void    game_set_fov(t_game *g, float fov)
+{
+    float   plane_len;
+
+    if (fov < FOV_MIN) fov = FOV_MIN;
+    if (fov > FOV_MAX) fov = FOV_MAX;
+    g->fov = fov;
+    /* Le plan caméra reste perpendiculaire à dir; seule sa longueur change */
+    plane_len = tanf(fov * 0.5f * (float)M_PI / 180.0f);
+    g->p.plane.x = -g->p.dir.y * plane_len;
+    g->p.plane.y =  g->p.dir.x * plane_len;
+}
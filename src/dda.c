@@ -0,0 +1,624 @@
+#include "game.h"
+#include <stdio.h>      /* fprintf() pour l'avertissement de sélection */
+#include <immintrin.h>  /* intrinsics SSE4.1 / AVX2 (activés par fonction) */
+
+/* ==========================================================================
+**  DDA — traversée des rayons par paquets
+**  --------------------------------------------------------------------------
+**  is_wall       : renvoie true si (mx,my) est un mur (ou hors carte = solide);
+**                  pour les déplacements, pas pour la DDA
+**  hits_alloc    : alloue le buffer SoA des impacts (une entrée par colonne)
+**  trace_scalar  : DDA classique, un rayon à la fois (fallback / référence)
+**  trace_sse4    : 4 rayons voisins avancés ensemble dans des lanes SSE
+**  trace_avx2    : 8 rayons voisins, occupation lue par gather AVX2
+**  dda_jump      : fait d'un coup les pas d'un rectangle vide (voir plus bas)
+**  dda_select    : choisit le traverseur selon le CPU (ou POKE3D_DDA), et
+**                  les sauts d'espace vide (POKE3D_SKIP=none|field|mip:
+**                  champ de distance de dfield.c par défaut, ou pyramide
+**                  d'occupation de mip.c)
+**
+**  Les pas sont calculés en forme fermée: side_x = side_x0 + nx * delta_x
+**  (nx = nombre de pas en X). Scalaire et SIMD font exactement les mêmes
+**  opérations flottantes et trouvent donc exactement les mêmes impacts.
+**
+**  Saut exact: la DDA fait ses pas en X aux paramètres Tx(n) = sx0 + n·dx
+**  et en Y à Ty(m) = sy0 + m·dy, le plus petit d'abord (Y si égalité).
+**  Si les ax cases suivantes en X et les ay suivantes en Y sont vides
+**  (carré du champ de distance, bloc de la pyramide), le rayon sort du
+**  rectangle au pas X numéro nx + ax ou au pas Y numéro ny + ay, le plus
+**  tôt des deux. dda_jump fait tous les pas qui précèdent cette sortie:
+**  ceux de l'axe de sortie, et sur l'autre axe exactement ceux que la DDA
+**  aurait faits avant (estimation par division, corrigée avec les mêmes
+**  comparaisons flottantes que la boucle). Le pas de sortie reste à la
+**  boucle: impacts identiques à la traversée case à case.
+**
+**  La grille (g->grid) a un bord plein: partis d'une case libre de la
+**  carte, les rayons s'arrêtent au plus tard sur le bord, la boucle lit
+**  donc la grille sans test de bornes. Seule la case de départ (caméra
+**  hors carte ou dans un mur) passe par is_wall, une fois par paquet.
+** ========================================================================== */
+
+bool    is_wall(const t_game *g, int mx, int my)
+{
+    /* Toute coordonnée hors carte est considérée "mur" (solide); le bord
+       de la grille est plein, seules les cases au-delà sont à tester */
+    if (mx < -1 || my < -1 || my > g->map_h || mx > g->map_w || !g->grid.cells)
+        return true;
+    return (GRID_SOLID(&g->grid, mx, my) != 0);
+}
+
+int     hits_alloc(t_hits *h, int count)
+{
+    size_t  n;
+
+    hits_free(h);
+    /* Arrondi à 8 pour que les stores SIMD des lanes de queue restent en bornes */
+    n = (size_t)((count + 7) & ~7);
+    if (posix_memalign((void **)&h->ray_dir_x, 32, n * sizeof(float))
+        || posix_memalign((void **)&h->ray_dir_y, 32, n * sizeof(float))
+        || posix_memalign((void **)&h->perp_dist, 32, n * sizeof(float))
+        || posix_memalign((void **)&h->wall_x, 32, n * sizeof(float))
+        || posix_memalign((void **)&h->map_x, 32, n * sizeof(int))
+        || posix_memalign((void **)&h->map_y, 32, n * sizeof(int))
+        || posix_memalign((void **)&h->side, 32, n * sizeof(int))
+        || posix_memalign((void **)&h->line_h, 32, n * sizeof(int))
+        || posix_memalign((void **)&h->draw_start, 32, n * sizeof(int))
+        || posix_memalign((void **)&h->draw_end, 32, n * sizeof(int)))
+        return (0);
+    h->count = count;
+    return (1);
+}
+
+void    hits_free(t_hits *h)
+{
+    free(h->ray_dir_x);
+    free(h->ray_dir_y);
+    free(h->perp_dist);
+    free(h->wall_x);
+    free(h->map_x);
+    free(h->map_y);
+    free(h->side);
+    free(h->line_h);
+    free(h->draw_start);
+    free(h->draw_end);
+    __builtin_memset(h, 0, sizeof(*h));
+}
+
+/* Compte des pas de l'autre axe: Y est pris avant le X de sortie si
+   Ty(m) <= tx, X avant le Y de sortie si Tx(m) < ty (même règle d'égalité
+   que la boucle DDA) */
+void    dda_jump(float sx0, float dx, float sy0, float dy, int ax, int ay,
+                 int *nx, int *ny)
+{
+    const float tx = sx0 + (float)(*nx + ax) * dx;
+    const float ty = sy0 + (float)(*ny + ay) * dy;
+    float       e;
+    int         m;
+
+    if (tx < ty)
+    {
+        e = (tx - sy0) / dy;
+        m = (e < (float)*ny) ? *ny : (e > (float)(*ny + ay)) ? *ny + ay : (int)e;
+        while (m < *ny + ay && sy0 + (float)m * dy <= tx)
+            m++;
+        while (m > *ny && sy0 + (float)(m - 1) * dy > tx)
+            m--;
+        *nx += ax;
+        *ny = m;
+        return ;
+    }
+    e = (ty - sx0) / dx;
+    m = (e < (float)*nx) ? *nx : (e > (float)(*nx + ax)) ? *nx + ax : (int)e;
+    while (m < *nx + ax && sx0 + (float)m * dx < ty)
+        m++;
+    while (m > *nx && !(sx0 + (float)(m - 1) * dx < ty))
+        m--;
+    *nx = m;
+    *ny += ay;
+}
+
+/* ---------- Scalaire: un rayon à la fois ---------- */
+
+static void trace_ray(const t_game *g, const t_view *v, int x, t_hits *h)
+{
+    /* x_cam ∈ [-1,1] : position horizontale normalisée de la colonne x */
+    float   x_cam = 2.0f * x / (float)v->w - 1.0f;
+    float   ray_dir_x = v->dir.x + v->plane.x * x_cam;
+    float   ray_dir_y = v->dir.y + v->plane.y * x_cam;
+    int     map_x = (int)v->pos.x;
+    int     map_y = (int)v->pos.y;
+    float   delta_x = (ray_dir_x == 0) ? 1e30f : fabsf(1.0f / ray_dir_x);
+    float   delta_y = (ray_dir_y == 0) ? 1e30f : fabsf(1.0f / ray_dir_y);
+    int     step_x, step_y;
+    float   side_x0, side_y0;
+    int     nx = 0, ny = 0;
+    int     hit_side = 0;
+
+    if (ray_dir_x < 0) { step_x = -1; side_x0 = (v->pos.x - map_x) * delta_x; }
+    else               { step_x =  1; side_x0 = (map_x + 1.0f - v->pos.x) * delta_x; }
+    if (ray_dir_y < 0) { step_y = -1; side_y0 = (v->pos.y - map_y) * delta_y; }
+    else               { step_y =  1; side_y0 = (map_y + 1.0f - v->pos.y) * delta_y; }
+
+    /* Boucle DDA : on avance toujours du côté le plus proche (X ou Y).
+       hit_side = 0 si impact vertical, 1 si horizontal. La case courante
+       est suivie par son index dans la grille (un pas = une addition);
+       loin des murs, dda_jump saute les pas qui restent dans le carré vide
+       du champ de distance ou dans le bloc vide de la pyramide autour de
+       la case (mêmes nx, ny qu'en les faisant un à un). */
+    if (!is_wall(g, map_x, map_y))
+    {
+        const unsigned char *cells = g->grid.cells;
+        const unsigned char *dist = g->grid.dist;
+        const long          row = (long)step_y * g->grid.stride;
+        long                idx = (long)map_y * g->grid.stride + map_x;
+        int                 lv = 0;
+        int                 ax;
+        int                 ay;
+        int                 a;
+        int                 b;
+
+        while (!cells[idx])
+        {
+            ax = 0;
+            ay = 0;
+            if (g->dda_skip == DDA_SKIP_FIELD && dist[idx] >= DF_MIN_SKIP)
+            {
+                ax = dist[idx] - 1;
+                ay = ax;
+            }
+            else if (g->dda_skip == DDA_SKIP_MIP)
+                lv = mip_block(&g->grid, map_x, map_y, step_x, step_y, lv, &ax, &ay);
+            if (ax | ay)
+            {
+                a = nx;
+                b = ny;
+                dda_jump(side_x0, delta_x, side_y0, delta_y, ax, ay, &nx, &ny);
+                map_x += (nx - a) * step_x;
+                map_y += (ny - b) * step_y;
+                idx += (long)(nx - a) * step_x + (long)(ny - b) * row;
+            }
+            if (side_x0 + (float)nx * delta_x < side_y0 + (float)ny * delta_y)
+            { nx++; map_x += step_x; idx += step_x; hit_side = 0; }
+            else
+            { ny++; map_y += step_y; idx += row; hit_side = 1; }
+        }
+    }
+
+    /* Distance perpendiculaire (anti fish-eye) + point d'impact le long du mur */
+    float   perp_dist, wall_x;
+    if (hit_side == 0)
+    {
+        perp_dist = (map_x - v->pos.x + (1 - step_x) * 0.5f) / ray_dir_x;
+        wall_x = v->pos.y + perp_dist * ray_dir_y;
+    }
+    else
+    {
+        perp_dist = (map_y - v->pos.y + (1 - step_y) * 0.5f) / ray_dir_y;
+        wall_x = v->pos.x + perp_dist * ray_dir_x;
+    }
+    wall_x -= floorf(wall_x);
+    if (perp_dist < 1e-6f) perp_dist = 1e-6f;
+
+    h->ray_dir_x[x] = ray_dir_x;
+    h->ray_dir_y[x] = ray_dir_y;
+    h->perp_dist[x] = perp_dist;
+    h->wall_x[x] = wall_x;
+    h->map_x[x] = map_x;
+    h->map_y[x] = map_y;
+    h->side[x] = hit_side;
+}
+
+static void trace_scalar(const t_game *g, const t_view *v, int x0, int x1, t_hits *h)
+{
+    while (x0 < x1)
+        trace_ray(g, v, x0++, h);
+}
+
+/* ---------- Sauts des paquets SIMD ---------- */
+
+/* Lanes d'un paquet recopiées en mémoire: les lanes loin des murs
+   (mask[l]) sautent avec le même dda_jump que le scalaire; dist = champ
+   de distance de la case (DDA_SKIP_FIELD), la pyramide est relue ici */
+typedef struct s_lanes
+{
+    float   sx0[8];
+    float   sy0[8];
+    float   dx[8];
+    float   dy[8];
+    float   nx[8];
+    float   ny[8];
+    int     mx[8];
+    int     my[8];
+    int     stx[8];
+    int     sty[8];
+    int     dist[8];
+    int     mask[8];
+}   t_lanes;
+
+static void lanes_jump(const t_game *g, t_lanes *l, int n)
+{
+    int ax;
+    int ay;
+    int a;
+    int b;
+    int i;
+
+    i = 0;
+    while (i < n)
+    {
+        if (l->mask[i])
+        {
+            ax = l->dist[i] - 1;
+            ay = ax;
+            if (g->dda_skip == DDA_SKIP_MIP)
+                mip_block(&g->grid, l->mx[i], l->my[i], l->stx[i], l->sty[i],
+                          MIP_MIN_LEVEL, &ax, &ay);
+            a = (int)l->nx[i];
+            b = (int)l->ny[i];
+            dda_jump(l->sx0[i], l->dx[i], l->sy0[i], l->dy[i], ax, ay, &a, &b);
+            l->mx[i] += (a - (int)l->nx[i]) * l->stx[i];
+            l->my[i] += (b - (int)l->ny[i]) * l->sty[i];
+            l->nx[i] = (float)a;
+            l->ny[i] = (float)b;
+        }
+        i++;
+    }
+}
+
+/* ---------- SSE4.1: paquets de 4 rayons ---------- */
+
+/* Occupation de 4 cases (bord compris). Pas de gather en SSE: on lit les
+   4 octets un par un. */
+__attribute__((target("sse4.1")))
+static __m128i occ_sse4(const t_game *g, __m128i mx, __m128i my)
+{
+    __m128i idx;
+    int     i[4];
+
+    idx = _mm_add_epi32(_mm_mullo_epi32(my, _mm_set1_epi32(g->grid.stride)), mx);
+    _mm_storeu_si128((__m128i *)i, idx);
+    idx = _mm_setr_epi32(g->grid.cells[i[0]], g->grid.cells[i[1]],
+                         g->grid.cells[i[2]], g->grid.cells[i[3]]);
+    /* solide = octet != 0 */
+    return (_mm_xor_si128(_mm_cmpeq_epi32(idx, _mm_setzero_si128()), _mm_set1_epi32(-1)));
+}
+
+/* Lanes qui peuvent sauter: distance >= DF_MIN_SKIP (*d reçoit le champ)
+   ou bloc de niveau MIP_MIN_LEVEL vide dans la pyramide */
+__attribute__((target("sse4.1")))
+static __m128i far_sse4(const t_game *g, __m128i mx, __m128i my, __m128i *d)
+{
+    const unsigned char *p;
+    __m128i             idx;
+    int                 i[4];
+
+    if (g->dda_skip == DDA_SKIP_MIP)
+    {
+        mx = _mm_srai_epi32(_mm_add_epi32(mx, _mm_set1_epi32(1)), MIP_MIN_LEVEL);
+        my = _mm_srai_epi32(_mm_add_epi32(my, _mm_set1_epi32(1)), MIP_MIN_LEVEL);
+        idx = _mm_add_epi32(_mm_mullo_epi32(my, _mm_set1_epi32(g->grid.mip_w[MIP_MIN_LEVEL])), mx);
+        p = g->grid.mip[MIP_MIN_LEVEL];
+    }
+    else
+    {
+        idx = _mm_add_epi32(_mm_mullo_epi32(my, _mm_set1_epi32(g->grid.stride)), mx);
+        p = g->grid.dist;
+    }
+    _mm_storeu_si128((__m128i *)i, idx);
+    *d = _mm_setr_epi32(p[i[0]], p[i[1]], p[i[2]], p[i[3]]);
+    if (g->dda_skip == DDA_SKIP_MIP)
+        return (_mm_cmpeq_epi32(*d, _mm_setzero_si128()));
+    return (_mm_cmpgt_epi32(*d, _mm_set1_epi32(DF_MIN_SKIP - 1)));
+}
+
+__attribute__((target("sse4.1")))
+static void trace_sse4(const t_game *g, const t_view *v, int x0, int x1, t_hits *h)
+{
+    const __m128    one = _mm_set1_ps(1.0f);
+    const __m128    zero = _mm_setzero_ps();
+    const __m128    big = _mm_set1_ps(1e30f);
+    const __m128    absm = _mm_castsi128_ps(_mm_set1_epi32(0x7FFFFFFF));
+    const __m128    px = _mm_set1_ps(v->pos.x);
+    const __m128    py = _mm_set1_ps(v->pos.y);
+    const __m128i   mx0 = _mm_set1_epi32((int)v->pos.x);
+    const __m128i   my0 = _mm_set1_epi32((int)v->pos.y);
+    const __m128i   ione = _mm_set1_epi32(1);
+
+    /* Départ hors carte ou dans un mur: cas rare, laissé au scalaire */
+    if (is_wall(g, (int)v->pos.x, (int)v->pos.y))
+    {
+        trace_scalar(g, v, x0, x1, h);
+        return ;
+    }
+    while (x0 + 4 <= x1)
+    {
+        __m128  xf = _mm_cvtepi32_ps(_mm_add_epi32(_mm_set1_epi32(x0), _mm_setr_epi32(0, 1, 2, 3)));
+        __m128  xc = _mm_sub_ps(_mm_div_ps(_mm_mul_ps(_mm_set1_ps(2.0f), xf),
+                                           _mm_set1_ps((float)v->w)), one);
+        __m128  rdx = _mm_add_ps(_mm_set1_ps(v->dir.x), _mm_mul_ps(_mm_set1_ps(v->plane.x), xc));
+        __m128  rdy = _mm_add_ps(_mm_set1_ps(v->dir.y), _mm_mul_ps(_mm_set1_ps(v->plane.y), xc));
+        __m128  dx = _mm_blendv_ps(_mm_and_ps(_mm_div_ps(one, rdx), absm), big, _mm_cmpeq_ps(rdx, zero));
+        __m128  dy = _mm_blendv_ps(_mm_and_ps(_mm_div_ps(one, rdy), absm), big, _mm_cmpeq_ps(rdy, zero));
+        __m128  negx = _mm_cmplt_ps(rdx, zero);
+        __m128  negy = _mm_cmplt_ps(rdy, zero);
+        __m128i stx = _mm_or_si128(_mm_castps_si128(negx), ione);   /* -1 ou +1 */
+        __m128i sty = _mm_or_si128(_mm_castps_si128(negy), ione);
+        __m128  mxf = _mm_cvtepi32_ps(mx0);
+        __m128  myf = _mm_cvtepi32_ps(my0);
+        __m128  sx0 = _mm_mul_ps(_mm_blendv_ps(_mm_sub_ps(_mm_add_ps(mxf, one), px),
+                                               _mm_sub_ps(px, mxf), negx), dx);
+        __m128  sy0 = _mm_mul_ps(_mm_blendv_ps(_mm_sub_ps(_mm_add_ps(myf, one), py),
+                                               _mm_sub_ps(py, myf), negy), dy);
+        __m128  nx = zero;
+        __m128  ny = zero;
+        __m128i mx = mx0;
+        __m128i my = my0;
+        __m128i side = _mm_setzero_si128();
+        __m128i active = _mm_xor_si128(occ_sse4(g, mx, my), _mm_set1_epi32(-1));
+
+        /* Pas masqués: les lanes qui ont touché un mur ne bougent plus */
+        while (_mm_movemask_epi8(active))
+        {
+            if (g->dda_skip)
+            {
+                __m128i d;
+                __m128i far = _mm_and_si128(active, far_sse4(g, mx, my, &d));
+
+                if (_mm_movemask_epi8(far))
+                {
+                    t_lanes l;
+
+                    _mm_storeu_ps(l.sx0, sx0);
+                    _mm_storeu_ps(l.sy0, sy0);
+                    _mm_storeu_ps(l.dx, dx);
+                    _mm_storeu_ps(l.dy, dy);
+                    _mm_storeu_ps(l.nx, nx);
+                    _mm_storeu_ps(l.ny, ny);
+                    _mm_storeu_si128((__m128i *)l.mx, mx);
+                    _mm_storeu_si128((__m128i *)l.my, my);
+                    _mm_storeu_si128((__m128i *)l.stx, stx);
+                    _mm_storeu_si128((__m128i *)l.sty, sty);
+                    _mm_storeu_si128((__m128i *)l.dist, d);
+                    _mm_storeu_si128((__m128i *)l.mask, far);
+                    lanes_jump(g, &l, 4);
+                    nx = _mm_loadu_ps(l.nx);
+                    ny = _mm_loadu_ps(l.ny);
+                    mx = _mm_loadu_si128((__m128i *)l.mx);
+                    my = _mm_loadu_si128((__m128i *)l.my);
+                }
+            }
+            __m128i cx = _mm_castps_si128(_mm_cmplt_ps(_mm_add_ps(sx0, _mm_mul_ps(nx, dx)),
+                                                       _mm_add_ps(sy0, _mm_mul_ps(ny, dy))));
+            __m128i sxm = _mm_and_si128(cx, active);
+            __m128i sym = _mm_andnot_si128(cx, active);
+
+            nx = _mm_add_ps(nx, _mm_and_ps(_mm_castsi128_ps(sxm), one));
+            ny = _mm_add_ps(ny, _mm_and_ps(_mm_castsi128_ps(sym), one));
+            mx = _mm_add_epi32(mx, _mm_and_si128(stx, sxm));
+            my = _mm_add_epi32(my, _mm_and_si128(sty, sym));
+            side = _mm_or_si128(_mm_andnot_si128(active, side), _mm_and_si128(sym, ione));
+            active = _mm_andnot_si128(occ_sse4(g, mx, my), active);
+        }
+
+        /* Distance perpendiculaire et point d'impact, les deux faces puis blend */
+        __m128  hs = _mm_castsi128_ps(_mm_cmpeq_epi32(side, ione));
+        __m128  pdx = _mm_div_ps(_mm_add_ps(_mm_sub_ps(_mm_cvtepi32_ps(mx), px),
+                        _mm_mul_ps(_mm_cvtepi32_ps(_mm_sub_epi32(ione, stx)), _mm_set1_ps(0.5f))), rdx);
+        __m128  pdy = _mm_div_ps(_mm_add_ps(_mm_sub_ps(_mm_cvtepi32_ps(my), py),
+                        _mm_mul_ps(_mm_cvtepi32_ps(_mm_sub_epi32(ione, sty)), _mm_set1_ps(0.5f))), rdy);
+        __m128  perp = _mm_blendv_ps(pdx, pdy, hs);
+        __m128  wall = _mm_blendv_ps(_mm_add_ps(py, _mm_mul_ps(perp, rdy)),
+                                     _mm_add_ps(px, _mm_mul_ps(perp, rdx)), hs);
+
+        wall = _mm_sub_ps(wall, _mm_floor_ps(wall));
+        perp = _mm_max_ps(perp, _mm_set1_ps(1e-6f));
+        _mm_storeu_ps(h->ray_dir_x + x0, rdx);
+        _mm_storeu_ps(h->ray_dir_y + x0, rdy);
+        _mm_storeu_ps(h->perp_dist + x0, perp);
+        _mm_storeu_ps(h->wall_x + x0, wall);
+        _mm_storeu_si128((__m128i *)(h->map_x + x0), mx);
+        _mm_storeu_si128((__m128i *)(h->map_y + x0), my);
+        _mm_storeu_si128((__m128i *)(h->side + x0), side);
+        x0 += 4;
+    }
+    trace_scalar(g, v, x0, x1, h);
+}
+
+/* ---------- AVX2: paquets de 8 rayons + gather d'occupation ---------- */
+
+__attribute__((target("avx2")))
+static __m256i occ_avx2(const t_game *g, __m256i mx, __m256i my)
+{
+    __m256i idx;
+    __m256i cell;
+
+    idx = _mm256_add_epi32(_mm256_mullo_epi32(my, _mm256_set1_epi32(g->grid.stride)), mx);
+    /* Gather 32 bits à l'octet près (échelle 1); index négatifs possibles
+       (bord gauche / haut), cells pointe une ligne et une case plus loin */
+    cell = _mm256_i32gather_epi32((const int *)g->grid.cells, idx, 1);
+    cell = _mm256_and_si256(cell, _mm256_set1_epi32(0xFF));
+    return (_mm256_xor_si256(_mm256_cmpeq_epi32(cell, _mm256_setzero_si256()),
+                             _mm256_set1_epi32(-1)));
+}
+
+__attribute__((target("avx2")))
+static __m256i far_avx2(const t_game *g, __m256i mx, __m256i my, __m256i *d)
+{
+    __m256i idx;
+
+    if (g->dda_skip == DDA_SKIP_MIP)
+    {
+        mx = _mm256_srai_epi32(_mm256_add_epi32(mx, _mm256_set1_epi32(1)), MIP_MIN_LEVEL);
+        my = _mm256_srai_epi32(_mm256_add_epi32(my, _mm256_set1_epi32(1)), MIP_MIN_LEVEL);
+        idx = _mm256_add_epi32(_mm256_mullo_epi32(my,
+                    _mm256_set1_epi32(g->grid.mip_w[MIP_MIN_LEVEL])), mx);
+        *d = _mm256_and_si256(_mm256_i32gather_epi32(
+                    (const int *)g->grid.mip[MIP_MIN_LEVEL], idx, 1), _mm256_set1_epi32(0xFF));
+        return (_mm256_cmpeq_epi32(*d, _mm256_setzero_si256()));
+    }
+    idx = _mm256_add_epi32(_mm256_mullo_epi32(my, _mm256_set1_epi32(g->grid.stride)), mx);
+    *d = _mm256_and_si256(_mm256_i32gather_epi32((const int *)g->grid.dist, idx, 1),
+                          _mm256_set1_epi32(0xFF));
+    return (_mm256_cmpgt_epi32(*d, _mm256_set1_epi32(DF_MIN_SKIP - 1)));
+}
+
+__attribute__((target("avx2")))
+static void trace_avx2(const t_game *g, const t_view *v, int x0, int x1, t_hits *h)
+{
+    const __m256    one = _mm256_set1_ps(1.0f);
+    const __m256    zero = _mm256_setzero_ps();
+    const __m256    big = _mm256_set1_ps(1e30f);
+    const __m256    absm = _mm256_castsi256_ps(_mm256_set1_epi32(0x7FFFFFFF));
+    const __m256    px = _mm256_set1_ps(v->pos.x);
+    const __m256    py = _mm256_set1_ps(v->pos.y);
+    const __m256i   mx0 = _mm256_set1_epi32((int)v->pos.x);
+    const __m256i   my0 = _mm256_set1_epi32((int)v->pos.y);
+    const __m256i   ione = _mm256_set1_epi32(1);
+
+    if (is_wall(g, (int)v->pos.x, (int)v->pos.y))
+    {
+        trace_scalar(g, v, x0, x1, h);
+        return ;
+    }
+    while (x0 + 8 <= x1)
+    {
+        __m256  xf = _mm256_cvtepi32_ps(_mm256_add_epi32(_mm256_set1_epi32(x0),
+                                        _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7)));
+        __m256  xc = _mm256_sub_ps(_mm256_div_ps(_mm256_mul_ps(_mm256_set1_ps(2.0f), xf),
+                                                 _mm256_set1_ps((float)v->w)), one);
+        __m256  rdx = _mm256_add_ps(_mm256_set1_ps(v->dir.x), _mm256_mul_ps(_mm256_set1_ps(v->plane.x), xc));
+        __m256  rdy = _mm256_add_ps(_mm256_set1_ps(v->dir.y), _mm256_mul_ps(_mm256_set1_ps(v->plane.y), xc));
+        __m256  dx = _mm256_blendv_ps(_mm256_and_ps(_mm256_div_ps(one, rdx), absm), big,
+                                      _mm256_cmp_ps(rdx, zero, _CMP_EQ_OQ));
+        __m256  dy = _mm256_blendv_ps(_mm256_and_ps(_mm256_div_ps(one, rdy), absm), big,
+                                      _mm256_cmp_ps(rdy, zero, _CMP_EQ_OQ));
+        __m256  negx = _mm256_cmp_ps(rdx, zero, _CMP_LT_OQ);
+        __m256  negy = _mm256_cmp_ps(rdy, zero, _CMP_LT_OQ);
+        __m256i stx = _mm256_or_si256(_mm256_castps_si256(negx), ione);
+        __m256i sty = _mm256_or_si256(_mm256_castps_si256(negy), ione);
+        __m256  mxf = _mm256_cvtepi32_ps(mx0);
+        __m256  myf = _mm256_cvtepi32_ps(my0);
+        __m256  sx0 = _mm256_mul_ps(_mm256_blendv_ps(_mm256_sub_ps(_mm256_add_ps(mxf, one), px),
+                                                     _mm256_sub_ps(px, mxf), negx), dx);
+        __m256  sy0 = _mm256_mul_ps(_mm256_blendv_ps(_mm256_sub_ps(_mm256_add_ps(myf, one), py),
+                                                     _mm256_sub_ps(py, myf), negy), dy);
+        __m256  nx = zero;
+        __m256  ny = zero;
+        __m256i mx = mx0;
+        __m256i my = my0;
+        __m256i side = _mm256_setzero_si256();
+        __m256i active = _mm256_xor_si256(occ_avx2(g, mx, my), _mm256_set1_epi32(-1));
+
+        while (!_mm256_testz_si256(active, active))
+        {
+            if (g->dda_skip)
+            {
+                __m256i d;
+                __m256i far = _mm256_and_si256(active, far_avx2(g, mx, my, &d));
+
+                if (!_mm256_testz_si256(far, far))
+                {
+                    t_lanes l;
+
+                    _mm256_storeu_ps(l.sx0, sx0);
+                    _mm256_storeu_ps(l.sy0, sy0);
+                    _mm256_storeu_ps(l.dx, dx);
+                    _mm256_storeu_ps(l.dy, dy);
+                    _mm256_storeu_ps(l.nx, nx);
+                    _mm256_storeu_ps(l.ny, ny);
+                    _mm256_storeu_si256((__m256i *)l.mx, mx);
+                    _mm256_storeu_si256((__m256i *)l.my, my);
+                    _mm256_storeu_si256((__m256i *)l.stx, stx);
+                    _mm256_storeu_si256((__m256i *)l.sty, sty);
+                    _mm256_storeu_si256((__m256i *)l.dist, d);
+                    _mm256_storeu_si256((__m256i *)l.mask, far);
+                    lanes_jump(g, &l, 8);
+                    nx = _mm256_loadu_ps(l.nx);
+                    ny = _mm256_loadu_ps(l.ny);
+                    mx = _mm256_loadu_si256((__m256i *)l.mx);
+                    my = _mm256_loadu_si256((__m256i *)l.my);
+                }
+            }
+            __m256i cx = _mm256_castps_si256(_mm256_cmp_ps(
+                            _mm256_add_ps(sx0, _mm256_mul_ps(nx, dx)),
+                            _mm256_add_ps(sy0, _mm256_mul_ps(ny, dy)), _CMP_LT_OQ));
+            __m256i sxm = _mm256_and_si256(cx, active);
+            __m256i sym = _mm256_andnot_si256(cx, active);
+
+            nx = _mm256_add_ps(nx, _mm256_and_ps(_mm256_castsi256_ps(sxm), one));
+            ny = _mm256_add_ps(ny, _mm256_and_ps(_mm256_castsi256_ps(sym), one));
+            mx = _mm256_add_epi32(mx, _mm256_and_si256(stx, sxm));
+            my = _mm256_add_epi32(my, _mm256_and_si256(sty, sym));
+            side = _mm256_or_si256(_mm256_andnot_si256(active, side), _mm256_and_si256(sym, ione));
+            active = _mm256_andnot_si256(occ_avx2(g, mx, my), active);
+        }
+
+        __m256  hs = _mm256_castsi256_ps(_mm256_cmpeq_epi32(side, ione));
+        __m256  pdx = _mm256_div_ps(_mm256_add_ps(_mm256_sub_ps(_mm256_cvtepi32_ps(mx), px),
+                        _mm256_mul_ps(_mm256_cvtepi32_ps(_mm256_sub_epi32(ione, stx)),
+                                      _mm256_set1_ps(0.5f))), rdx);
+        __m256  pdy = _mm256_div_ps(_mm256_add_ps(_mm256_sub_ps(_mm256_cvtepi32_ps(my), py),
+                        _mm256_mul_ps(_mm256_cvtepi32_ps(_mm256_sub_epi32(ione, sty)),
+                                      _mm256_set1_ps(0.5f))), rdy);
+        __m256  perp = _mm256_blendv_ps(pdx, pdy, hs);
+        __m256  wall = _mm256_blendv_ps(_mm256_add_ps(py, _mm256_mul_ps(perp, rdy)),
+                                        _mm256_add_ps(px, _mm256_mul_ps(perp, rdx)), hs);
+
+        wall = _mm256_sub_ps(wall, _mm256_floor_ps(wall));
+        perp = _mm256_max_ps(perp, _mm256_set1_ps(1e-6f));
+        _mm256_storeu_ps(h->ray_dir_x + x0, rdx);
+        _mm256_storeu_ps(h->ray_dir_y + x0, rdy);
+        _mm256_storeu_ps(h->perp_dist + x0, perp);
+        _mm256_storeu_ps(h->wall_x + x0, wall);
+        _mm256_storeu_si256((__m256i *)(h->map_x + x0), mx);
+        _mm256_storeu_si256((__m256i *)(h->map_y + x0), my);
+        _mm256_storeu_si256((__m256i *)(h->side + x0), side);
+        x0 += 8;
+    }
+    trace_sse4(g, v, x0, x1, h);
+}
+
+/* ---------- Sélection à l'exécution ---------- */
+
+static int  cpu_has(const char *name)
+{
+    __builtin_cpu_init();
+    if (!strcmp(name, "avx2"))
+        return (__builtin_cpu_supports("avx2"));
+    if (!strcmp(name, "sse4"))
+        return (__builtin_cpu_supports("sse4.1"));
+    return (1);
+}
+
+void    dda_select(t_game *g)
+{
+    const char  *want = getenv("POKE3D_DDA");
+    const char  *skip = getenv("POKE3D_SKIP");
+
+    /* Sauts d'espace vide: champ de distance sauf POKE3D_SKIP=none|mip */
+    g->dda_skip = DDA_SKIP_FIELD;
+    if (skip && !strcmp(skip, "none"))
+        g->dda_skip = DDA_SKIP_NONE;
+    else if (skip && !strcmp(skip, "mip"))
+        g->dda_skip = DDA_SKIP_MIP;
+
+    /* Choix forcé (scalar / sse4 / avx2) si le CPU le permet */
+    if (want && !strcmp(want, "scalar"))
+        g->dda = trace_scalar, g->dda_name = "scalar";
+    else if (want && !strcmp(want, "sse4") && cpu_has("sse4"))
+        g->dda = trace_sse4, g->dda_name = "sse4";
+    else if (want && !strcmp(want, "avx2") && cpu_has("avx2"))
+        g->dda = trace_avx2, g->dda_name = "avx2";
+    else
+    {
+        if (want && *want)
+            fprintf(stderr, "poke3d: POKE3D_DDA=%s unavailable, auto-detecting\n", want);
+        /* Détection automatique: le plus large jeu d'instructions disponible */
+        if (cpu_has("avx2"))
+            g->dda = trace_avx2, g->dda_name = "avx2";
+        else if (cpu_has("sse4"))
+            g->dda = trace_sse4, g->dda_name = "sse4";
+        else
+            g->dda = trace_scalar, g->dda_name = "scalar";
+    }
+}
@@ -0,0 +1,290 @@
+#include "game.h"
+#include <immintrin.h>  /* SSE2: passes du chanfrein par 16 cases */
+
+/* ==========================================================================
+**  Champ de distance — saut d'espace vide pour la DDA
+**  --------------------------------------------------------------------------
+**  dist(c) = distance de Chebyshev de la case c au mur le plus proche
+**  (max(|dx|, |dy|), 0 sur un mur, bornée à DF_MAX). Si dist(c) = k, le
+**  carré de rayon k - 1 centré sur c est vide: un rayon qui part de c y
+**  traverse au moins k - 1 cases en X ou en Y sans rien toucher: la DDA
+**  fait dda_jump(k - 1, k - 1) (dda.c) jusqu'au pas de sortie du carré.
+**
+**  df_build  : champ complet, deux passes (chanfrein 8-voisins, exact pour
+**              Chebyshev), 16 cases à la fois en SSE2
+**  df_update : mise à jour locale après le changement d'une case
+** ========================================================================== */
+
+/* Constantes des passes, calculées une fois par df_passes (en -O0 chaque
+   _mm_set1_epi8 coûte 16 écritures d'octets) */
+typedef struct s_df_k
+{
+    __m128i c[4];       /* 1, 2, 4, 8 dans chaque octet */
+    __m128i lo[3];      /* 0xFF sur les 2, 4, 8 octets bas */
+    __m128i hi[3];      /* 0xFF sur les 2, 4, 8 octets hauts */
+}   t_df_k;
+
+__attribute__((target("sse2")))
+static void df_k_init(t_df_k *k)
+{
+    const __m128i   ones = _mm_set1_epi8(-1);
+
+    k->c[0] = _mm_set1_epi8(1);
+    k->c[1] = _mm_set1_epi8(2);
+    k->c[2] = _mm_set1_epi8(4);
+    k->c[3] = _mm_set1_epi8(8);
+    k->lo[0] = _mm_srli_si128(ones, 14);
+    k->lo[1] = _mm_srli_si128(ones, 12);
+    k->lo[2] = _mm_srli_si128(ones, 8);
+    k->hi[0] = _mm_slli_si128(ones, 14);
+    k->hi[1] = _mm_slli_si128(ones, 12);
+    k->hi[2] = _mm_slli_si128(ones, 8);
+}
+
+/* min(d, 1 + min des 3 voisins de la ligne n) pour 16 cases (additions
+   saturées: 255 + 1 reste 255) */
+__attribute__((target("sse2")))
+static __m128i  df_three(const unsigned char *d, const unsigned char *n, __m128i one)
+{
+    __m128i v;
+
+    v = _mm_min_epu8(_mm_loadu_si128((const __m128i *)(n - 1)),
+                     _mm_loadu_si128((const __m128i *)n));
+    v = _mm_min_epu8(v, _mm_loadu_si128((const __m128i *)(n + 1)));
+    return (_mm_min_epu8(_mm_loadu_si128((const __m128i *)d), _mm_adds_epu8(v, one)));
+}
+
+/* Passe avant sur une ligne, 16 cases à la fois: v = min(d, voisins du
+   dessus + 1), puis le préfixe D[x] = min(v[x], D[x - 1] + 1) en décalages
+   de 1, 2, 4 et 8 cases. Le décalage de 1 fait entrer la dernière case du
+   bloc précédent (déjà finie, d[-1] au départ), les suivants des 0xFF
+   (neutres). Renvoie le nombre de cases faites */
+__attribute__((target("sse2")))
+static int  df_fwd_sse(unsigned char *d, const unsigned char *n, int len,
+                       const t_df_k *k)
+{
+    __m128i v;
+    __m128i c;
+    int     i;
+
+    c = _mm_loadu_si128((const __m128i *)(d - 16));
+    i = 0;
+    while (i + 16 <= len)
+    {
+        v = df_three(d + i, n + i, k->c[0]);
+        v = _mm_min_epu8(v, _mm_adds_epu8(_mm_or_si128(_mm_slli_si128(v, 1),
+                                          _mm_srli_si128(c, 15)), k->c[0]));
+        v = _mm_min_epu8(v, _mm_adds_epu8(_mm_or_si128(_mm_slli_si128(v, 2), k->lo[0]), k->c[1]));
+        v = _mm_min_epu8(v, _mm_adds_epu8(_mm_or_si128(_mm_slli_si128(v, 4), k->lo[1]), k->c[2]));
+        v = _mm_min_epu8(v, _mm_adds_epu8(_mm_or_si128(_mm_slli_si128(v, 8), k->lo[2]), k->c[3]));
+        _mm_storeu_si128((__m128i *)(d + i), v);
+        c = v;
+        i += 16;
+    }
+    return (i);
+}
+
+/* Passe arrière, miroir de df_fwd_sse: d et n pointent sur la case la plus
+   à droite, les blocs de 16 avancent vers la gauche (d[1] au départ) */
+__attribute__((target("sse2")))
+static int  df_bwd_sse(unsigned char *d, const unsigned char *n, int len,
+                       const t_df_k *k)
+{
+    __m128i v;
+    __m128i c;
+    int     i;
+
+    c = _mm_loadu_si128((const __m128i *)(d + 1));
+    i = 0;
+    while (i + 16 <= len)
+    {
+        v = df_three(d - i - 15, n - i - 15, k->c[0]);
+        v = _mm_min_epu8(v, _mm_adds_epu8(_mm_or_si128(_mm_srli_si128(v, 1),
+                                          _mm_slli_si128(c, 15)), k->c[0]));
+        v = _mm_min_epu8(v, _mm_adds_epu8(_mm_or_si128(_mm_srli_si128(v, 2), k->hi[0]), k->c[1]));
+        v = _mm_min_epu8(v, _mm_adds_epu8(_mm_or_si128(_mm_srli_si128(v, 4), k->hi[1]), k->c[2]));
+        v = _mm_min_epu8(v, _mm_adds_epu8(_mm_or_si128(_mm_srli_si128(v, 8), k->hi[2]), k->c[3]));
+        _mm_storeu_si128((__m128i *)(d - i - 15), v);
+        c = v;
+        i += 16;
+    }
+    return (i);
+}
+
+/* Reste d'une ligne case par case (dir = +1 avant, -1 arrière); la case
+   d[-dir] est déjà finie. Comparaison en int: 1 + DF_MAX ne tient pas dans
+   un octet */
+static void df_tail(unsigned char *d, const unsigned char *n, int len, int dir)
+{
+    int side;
+    int v;
+
+    side = d[-dir];
+    while (len-- > 0)
+    {
+        v = n[-1];
+        if (n[0] < v) v = n[0];
+        if (n[1] < v) v = n[1];
+        if (side < v) v = side;
+        side = *d;
+        if (v + 1 < side)
+            *d = (unsigned char)(side = v + 1);
+        d += dir;
+        n += dir;
+    }
+}
+
+/* Passe avant (haut-gauche) puis arrière (bas-droite) sur les cases
+   [x0, x1] × [y0, y1]; les voisins hors de la fenêtre servent de sources */
+static void df_passes(t_grid *gr, int x0, int y0, int x1, int y1)
+{
+    unsigned char   *d;
+    const int       s = gr->stride;
+    const int       len = x1 - x0 + 1;
+    t_df_k          kk;
+    int             k;
+    int             y;
+
+    df_k_init(&kk);
+    y = y0;
+    while (y <= y1)
+    {
+        d = &GRID_DIST(gr, x0, y);
+        k = df_fwd_sse(d, d - s, len, &kk);
+        df_tail(d + k, d + k - s, len - k, 1);
+        y++;
+    }
+    y = y1;
+    while (y >= y0)
+    {
+        d = &GRID_DIST(gr, x1, y);
+        k = df_bwd_sse(d, d + s, len, &kk);
+        df_tail(d - k, d - k + s, len - k, -1);
+        y--;
+    }
+}
+
+/* Mur -> 0, vide -> DF_MAX, 16 octets à la fois (plans alignés, taille
+   multiple de GRID_ALIGN) */
+__attribute__((target("sse2")))
+static void df_seed(unsigned char *field, const unsigned char *solid, size_t n)
+{
+    const __m128i   zero = _mm_setzero_si128();
+    const __m128i   far = _mm_set1_epi8((char)DF_MAX);
+    size_t          i;
+
+    i = 0;
+    while (i + 16 <= n)
+    {
+        _mm_store_si128((__m128i *)(field + i),
+                        _mm_and_si128(far, _mm_cmpeq_epi8(
+                            _mm_load_si128((const __m128i *)(solid + i)), zero)));
+        i += 16;
+    }
+    while (i < n)
+    {
+        field[i] = solid[i] ? 0 : DF_MAX;
+        i++;
+    }
+}
+
+void    df_build(t_grid *gr, int w, int h)
+{
+    df_seed(gr->field, gr->solid, (size_t)gr->stride * (h + 2));
+    if (w > 0 && h > 0)
+        df_passes(gr, 0, 0, w - 1, h - 1);
+}
+
+/* Anneau de rayon r autour de (cx, cy), borné à la carte: *hi reçoit la
+   plus grande distance de l'anneau; si r_set > 0, les distances > r_set
+   sont ramenées à r_set et le nombre de cases changées est renvoyé */
+static int  df_ring(t_grid *gr, int w, int h, int cx, int cy, int r, int r_set,
+                    int *hi)
+{
+    unsigned char   *d;
+    int             changed;
+    int             x;
+    int             y;
+
+    changed = 0;
+    *hi = -1;
+    y = (cy - r < 0) ? 0 : cy - r;
+    while (y <= cy + r && y < h)
+    {
+        x = (cx - r < 0) ? 0 : cx - r;
+        while (x <= cx + r && x < w)
+        {
+            /* Entre la première et la dernière ligne: les deux bords seuls */
+            if (y != cy - r && y != cy + r && x != cx - r && x != cx + r)
+                x = cx + r;
+            if (x >= w)
+                break ;
+            d = &GRID_DIST(gr, x, y);
+            if (r_set > 0 && *d > r_set)
+            {
+                *d = (unsigned char)r_set;
+                changed++;
+            }
+            if (*d > *hi)
+                *hi = *d;
+            x++;
+        }
+        y++;
+    }
+    return (changed);
+}
+
+/* Un mur posé ne fait que rapprocher: anneaux croissants jusqu'au premier
+   qui ne change pas (le champ est 1-lipschitzien, les suivants non plus).
+   Un mur retiré peut éloigner: on cherche le premier anneau r dont toutes
+   les cases ont dist < r (leur mur le plus proche est un autre, valeurs
+   encore justes), puis on recalcule le carré intérieur à partir de lui. */
+void    df_update(t_grid *gr, int w, int h, int x, int y)
+{
+    unsigned char   *d;
+    int             hi;
+    int             r;
+    int             i;
+    int             j;
+
+    if (GRID_SOLID(gr, x, y))
+    {
+        if (GRID_DIST(gr, x, y) == 0)
+            return ;
+        GRID_DIST(gr, x, y) = 0;
+        r = 1;
+        while (r <= DF_MAX && df_ring(gr, w, h, x, y, r, r, &hi) > 0)
+            r++;
+        return ;
+    }
+    if (GRID_DIST(gr, x, y) != 0)
+        return ;
+    /* Fenêtre = carré de rayon r - 1 à l'intérieur de l'anneau source r;
+       une fenêtre qui couvre la carte n'a besoin que du bord plein */
+    r = 1;
+    while (r <= DF_MAX)
+    {
+        if (x - r < 0 && y - r < 0 && x + r >= w && y + r >= h)
+            break ;
+        df_ring(gr, w, h, x, y, r, 0, &hi);
+        if (hi < r)
+            break ;
+        r++;
+    }
+    r--;
+    /* Carré de rayon r (borné à la carte) repris de zéro */
+    j = (y - r < 0) ? 0 : y - r;
+    while (j <= y + r && j < h)
+    {
+        i = (x - r < 0) ? 0 : x - r;
+        d = &GRID_DIST(gr, i, j);
+        while (i <= x + r && i < w)
+        {
+            *d++ = GRID_SOLID(gr, i, j) ? 0 : DF_MAX;
+            i++;
+        }
+        j++;
+    }
+    df_passes(gr, (x - r < 0) ? 0 : x - r, (y - r < 0) ? 0 : y - r,
+              (x + r >= w) ? w - 1 : x + r, (y + r >= h) ? h - 1 : y + r);
+}
@@ -0,0 +1,219 @@
+#include "game.h"
+#include <immintrin.h>  /* intrinsics SSE / AVX2 (activés par fonction) */
+
+/* ==========================================================================
+**  Framebuffer transposé (mode FB_TRANSPOSED)
+**  --------------------------------------------------------------------------
+**  Les murs s'écrivent colonne par colonne: dans l'image MLX (row-major),
+**  chaque pixel d'une bande est à line_len octets du précédent, donc une
+**  nouvelle ligne de cache par pixel. En mode transposé, les colonnes sont
+**  écrites dans un framebuffer de travail column-major (g->colfb, une
+**  colonne = pixels contigus), puis stage_transpose recopie ce buffer dans
+**  l'image MLX par blocs 8x8 (AVX2) ou 4x4 (SSE) avant l'affichage.
+**
+**  fb_mode_from_env : FB_DIRECT (défaut) ou FB_TRANSPOSED via POKE3D_FB
+**  colfb_ensure     : (ré)alloue le buffer column-major à la taille de la frame
+**  colfb_free       : libère le buffer
+**  transpose_select : choisit le noyau de transposition selon le CPU
+**  stage_transpose  : passe de rendu — recopie les colonnes [x0,x1) dans l'image
+** ========================================================================== */
+
+int     fb_mode_from_env(void)
+{
+    const char  *env = getenv("POKE3D_FB");
+
+    if (env && !strcmp(env, "transposed"))
+        return (FB_TRANSPOSED);
+    return (FB_DIRECT);
+}
+
+int     colfb_ensure(t_game *g)
+{
+    t_img   *c = &g->colfb;
+    int     stride;
+
+    /* Hauteur de colonne arrondie à 8: les blocs 8x8 restent alignés */
+    stride = (g->frame.h + 7) & ~7;
+    if (c->px && c->w == g->frame.w && c->line_len == stride)
+        return (1);
+    colfb_free(g);
+    if (posix_memalign((void **)&c->px, 64, sizeof(unsigned int) * stride * g->frame.w))
+    {
+        c->px = NULL;
+        return (0);
+    }
+    c->w = g->frame.w;
+    c->h = g->frame.h;
+    c->line_len = stride;   /* ici: pixels par COLONNE (pas des octets) */
+    c->bpp = 32;
+    c->layout = TEX_COL_MAJOR;
+    /* Table de lignes pour l'API span: colonne x = x * stride pixels */
+    if (!img_rows_build(c, c->px, stride, 1))
+    {
+        colfb_free(g);
+        return (0);
+    }
+    return (1);
+}
+
+void    colfb_free(t_game *g)
+{
+    free(g->colfb.px);
+    img_rows_free(&g->colfb);
+    __builtin_memset(&g->colfb, 0, sizeof(g->colfb));
+}
+
+/* ---------- Noyaux: transposent un bloc de N colonnes x N lignes ----------
+   src = colonne x0 ligne y0 dans colfb (sstride pixels entre colonnes)
+   dst = ligne y0 colonne x0 dans l'image (dstride pixels entre lignes) */
+
+static void tr_block_scalar(const unsigned int *src, int sstride,
+                            unsigned int *dst, int dstride, int nx, int ny)
+{
+    int i;
+    int j;
+
+    j = 0;
+    while (j < ny)
+    {
+        i = 0;
+        while (i < nx)
+        {
+            dst[j * dstride + i] = src[i * sstride + j];
+            i++;
+        }
+        j++;
+    }
+}
+
+__attribute__((target("sse2")))
+static void tr_block_sse(const unsigned int *src, int sstride,
+                         unsigned int *dst, int dstride)
+{
+    __m128  r0 = _mm_loadu_ps((const float *)(src));
+    __m128  r1 = _mm_loadu_ps((const float *)(src + sstride));
+    __m128  r2 = _mm_loadu_ps((const float *)(src + 2 * sstride));
+    __m128  r3 = _mm_loadu_ps((const float *)(src + 3 * sstride));
+
+    _MM_TRANSPOSE4_PS(r0, r1, r2, r3);
+    _mm_storeu_ps((float *)(dst), r0);
+    _mm_storeu_ps((float *)(dst + dstride), r1);
+    _mm_storeu_ps((float *)(dst + 2 * dstride), r2);
+    _mm_storeu_ps((float *)(dst + 3 * dstride), r3);
+}
+
+__attribute__((target("avx2")))
+static void tr_block_avx2(const unsigned int *src, int sstride,
+                          unsigned int *dst, int dstride)
+{
+    __m256  r0 = _mm256_load_ps((const float *)(src));
+    __m256  r1 = _mm256_load_ps((const float *)(src + sstride));
+    __m256  r2 = _mm256_load_ps((const float *)(src + 2 * sstride));
+    __m256  r3 = _mm256_load_ps((const float *)(src + 3 * sstride));
+    __m256  r4 = _mm256_load_ps((const float *)(src + 4 * sstride));
+    __m256  r5 = _mm256_load_ps((const float *)(src + 5 * sstride));
+    __m256  r6 = _mm256_load_ps((const float *)(src + 6 * sstride));
+    __m256  r7 = _mm256_load_ps((const float *)(src + 7 * sstride));
+    __m256  t0, t1, t2, t3, t4, t5, t6, t7;
+    __m256  u0, u1, u2, u3, u4, u5, u6, u7;
+
+    /* Transposition 8x8 classique: unpack 32 bits, shuffle 64 bits, permute 128 bits */
+    t0 = _mm256_unpacklo_ps(r0, r1);
+    t1 = _mm256_unpackhi_ps(r0, r1);
+    t2 = _mm256_unpacklo_ps(r2, r3);
+    t3 = _mm256_unpackhi_ps(r2, r3);
+    t4 = _mm256_unpacklo_ps(r4, r5);
+    t5 = _mm256_unpackhi_ps(r4, r5);
+    t6 = _mm256_unpacklo_ps(r6, r7);
+    t7 = _mm256_unpackhi_ps(r6, r7);
+    u0 = _mm256_shuffle_ps(t0, t2, 0x44);
+    u1 = _mm256_shuffle_ps(t0, t2, 0xEE);
+    u2 = _mm256_shuffle_ps(t1, t3, 0x44);
+    u3 = _mm256_shuffle_ps(t1, t3, 0xEE);
+    u4 = _mm256_shuffle_ps(t4, t6, 0x44);
+    u5 = _mm256_shuffle_ps(t4, t6, 0xEE);
+    u6 = _mm256_shuffle_ps(t5, t7, 0x44);
+    u7 = _mm256_shuffle_ps(t5, t7, 0xEE);
+    _mm256_storeu_ps((float *)(dst), _mm256_permute2f128_ps(u0, u4, 0x20));
+    _mm256_storeu_ps((float *)(dst + dstride), _mm256_permute2f128_ps(u1, u5, 0x20));
+    _mm256_storeu_ps((float *)(dst + 2 * dstride), _mm256_permute2f128_ps(u2, u6, 0x20));
+    _mm256_storeu_ps((float *)(dst + 3 * dstride), _mm256_permute2f128_ps(u3, u7, 0x20));
+    _mm256_storeu_ps((float *)(dst + 4 * dstride), _mm256_permute2f128_ps(u0, u4, 0x31));
+    _mm256_storeu_ps((float *)(dst + 5 * dstride), _mm256_permute2f128_ps(u1, u5, 0x31));
+    _mm256_storeu_ps((float *)(dst + 6 * dstride), _mm256_permute2f128_ps(u2, u6, 0x31));
+    _mm256_storeu_ps((float *)(dst + 7 * dstride), _mm256_permute2f128_ps(u3, u7, 0x31));
+}
+
+/* Bloc 8x8 en quatre 4x4 SSE (CPU sans AVX2) */
+static void tr_block8_sse(const unsigned int *src, int sstride,
+                          unsigned int *dst, int dstride)
+{
+    tr_block_sse(src, sstride, dst, dstride);
+    tr_block_sse(src + 4, sstride, dst + 4 * dstride, dstride);
+    tr_block_sse(src + 4 * sstride, sstride, dst + 4, dstride);
+    tr_block_sse(src + 4 * sstride + 4, sstride, dst + 4 * dstride + 4, dstride);
+}
+
+static void tr_block8_scalar(const unsigned int *src, int sstride,
+                             unsigned int *dst, int dstride)
+{
+    tr_block_scalar(src, sstride, dst, dstride, 8, 8);
+}
+
+void    transpose_select(t_game *g)
+{
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2"))
+        g->tr_block = tr_block_avx2, g->tr_name = "avx2-8x8";
+    else if (__builtin_cpu_supports("sse2"))
+        g->tr_block = tr_block8_sse, g->tr_name = "sse-4x4";
+    else
+        g->tr_block = tr_block8_scalar, g->tr_name = "scalar";
+}
+
+/* Recopie les colonnes [x0, x1) de colfb dans l'image. Seules les lignes
+   où au moins une colonne du bloc a du mur sont utiles (le reste sera
+   recouvert par le ciel et le sol): on borne chaque bloc de 8 colonnes à
+   [min draw_start, max draw_end]. */
+void    stage_transpose(t_game *g, int x0, int x1)
+{
+    const t_img         *c = &g->colfb;
+    const int           sstride = c->line_len;
+    const int           dstride = g->frame.line_len / 4;
+    unsigned int        *img = (unsigned int *)g->frame.addr;
+    int                 bx;
+    int                 nx;
+    int                 y0;
+    int                 y1;
+    int                 i;
+
+    bx = x0;
+    while (bx < x1)
+    {
+        nx = (x1 - bx < 8) ? x1 - bx : 8;
+        y0 = g->view.h;
+        y1 = 0;
+        i = 0;
+        while (i < nx)
+        {
+            if (g->hits.draw_start[bx + i] < y0) y0 = g->hits.draw_start[bx + i];
+            if (g->hits.draw_end[bx + i] + 1 > y1) y1 = g->hits.draw_end[bx + i] + 1;
+            i++;
+        }
+        y0 &= ~7;
+        while (y0 < y1)
+        {
+            const unsigned int  *src = c->px + bx * sstride + y0;
+            unsigned int        *dst = img + y0 * dstride + bx;
+
+            /* Blocs pleins 8x8 via le noyau SIMD, bords en scalaire */
+            if (nx == 8 && y0 + 8 <= g->view.h)
+                g->tr_block(src, sstride, dst, dstride);
+            else
+                tr_block_scalar(src, sstride, dst, dstride, nx,
+                                (g->view.h - y0 < 8) ? g->view.h - y0 : 8);
+            y0 += 8;
+        }
+        bx += nx;
+    }
+}
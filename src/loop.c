@@ -0,0 +1,237 @@
+#include "game.h"
+#include <unistd.h>   /* usleep() */
+
+/* ==========================================================================
+**  Hooks clavier + boucle principale
+**  --------------------------------------------------------------------------
+**  key_press   : met à true les flags de touches pressées (WASD, flèches);
+**                - et = demandent la résolution précédente / suivante;
+**                P affiche / masque le profileur (make PROFILE=1)
+**  key_release : met à false les flags de touches relâchées
+**  move_and_rotate : applique les déplacements (avec collision) et la rotation,
+**                    note le déplacement du tick (p.vel), puis ramasse les
+**                    Pokéballs touchées
+**  sky_tick    : avance le défilement du ciel à sa propre cadence
+**  loop_start  : origine du défilement du ciel + première frame
+**  on_expose   : la fenêtre doit être ré-affichée (sans recalcul)
+**  loop_hook   : tick + mouvement, puis rendu SEULEMENT si quelque chose a
+**                changé (caméra, ciel, carte), simple ré-affichage après un
+**                Expose, sinon courte pause (pas de cœur brûlé à vide)
+** ========================================================================== */
+
+/* Préréglage voisin de la taille courante (dir = -1 plus petit, +1 plus grand) */
+static void request_preset(t_game *g, int dir)
+{
+    static const int    presets[][2] = RES_PRESETS;
+    const int           n = (int)(sizeof(presets) / sizeof(presets[0]));
+    int                 i;
+
+    i = (dir > 0) ? 0 : n - 1;
+    while (i >= 0 && i < n)
+    {
+        if ((dir > 0 && presets[i][0] * presets[i][1] > g->win_w * g->win_h)
+            || (dir < 0 && presets[i][0] * presets[i][1] < g->win_w * g->win_h))
+        {
+            g->want_w = presets[i][0];
+            g->want_h = presets[i][1];
+            return ;
+        }
+        i += dir;
+    }
+}
+
+int     key_press(int keycode, t_game *g)
+{
+    if (keycode == KEY_ESC) close_window(g); /* Fermeture immédiate */
+    else if (keycode == KEY_W) g->keys.w = true;
+    else if (keycode == KEY_A) g->keys.a = true;
+    else if (keycode == KEY_S) g->keys.s = true;
+    else if (keycode == KEY_D) g->keys.d = true;
+    else if (keycode == KEY_LEFT)  g->keys.left = true;
+    else if (keycode == KEY_RIGHT) g->keys.right = true;
+    else if (keycode == KEY_MINUS) request_preset(g, -1);
+    else if (keycode == KEY_EQUAL) request_preset(g, +1);
+#ifdef POKE3D_PROFILE
+    else if (keycode == KEY_P)
+    {
+        g->prof.overlay = !g->prof.overlay;
+        render_invalidate(g, DIRTY_HUD);
+    }
+#endif
+    return (0);
+}
+
+int     key_release(int keycode, t_game *g)
+{
+    if (keycode == KEY_W) g->keys.w = false;
+    else if (keycode == KEY_A) g->keys.a = false;
+    else if (keycode == KEY_S) g->keys.s = false;
+    else if (keycode == KEY_D) g->keys.d = false;
+    else if (keycode == KEY_LEFT)  g->keys.left = false;
+    else if (keycode == KEY_RIGHT) g->keys.right = false;
+    return (0);
+}
+
+static void move_and_rotate(t_game *g)
+{
+    /* Vecteur avant (direction du joueur) et droite (dir tournée de 90°) */
+    t_v2f forward = g->p.dir;
+    t_v2f right = (t_v2f){ g->p.dir.y, -g->p.dir.x };
+    t_v2f from = g->p.pos;
+    float nx, ny;
+
+    /* Avancer (W) : on essaie d'avancer sur X puis Y en vérifiant les murs (collision AABB simple) */
+    if (g->keys.w)
+    {
+        nx = g->p.pos.x + forward.x * MOVE_SPEED;
+        ny = g->p.pos.y + forward.y * MOVE_SPEED;
+        if (!is_wall(g, (int)nx, (int)g->p.pos.y)) g->p.pos.x = nx;
+        if (!is_wall(g, (int)g->p.pos.x, (int)ny)) g->p.pos.y = ny;
+    }
+    /* Reculer (S) : pareil mais en sens inverse */
+    if (g->keys.s)
+    {
+        nx = g->p.pos.x - forward.x * MOVE_SPEED;
+        ny = g->p.pos.y - forward.y * MOVE_SPEED;
+        if (!is_wall(g, (int)nx, (int)g->p.pos.y)) g->p.pos.x = nx;
+        if (!is_wall(g, (int)g->p.pos.x, (int)ny)) g->p.pos.y = ny;
+    }
+    /* Strafe gauche (A) : déplacement latéral à gauche (vector right négatif) */
+    if (g->keys.a)
+    {
+        nx = g->p.pos.x - right.x * MOVE_SPEED;
+        ny = g->p.pos.y - right.y * MOVE_SPEED;
+        if (!is_wall(g, (int)nx, (int)g->p.pos.y)) g->p.pos.x = nx;
+        if (!is_wall(g, (int)g->p.pos.x, (int)ny)) g->p.pos.y = ny;
+    }
+    /* Strafe droit (D) : déplacement latéral à droite (vector right positif) */
+    if (g->keys.d)
+    {
+        nx = g->p.pos.x + right.x * MOVE_SPEED;
+        ny = g->p.pos.y + right.y * MOVE_SPEED;
+        if (!is_wall(g, (int)nx, (int)g->p.pos.y)) g->p.pos.x = nx;
+        if (!is_wall(g, (int)g->p.pos.x, (int)ny)) g->p.pos.y = ny;
+    }
+
+    /* Rotation gauche/droite via matrices de rotation 2D sur dir et plane */
+    if (g->keys.left || g->keys.right)
+    {
+        float ang = (g->keys.left ? -ROT_SPEED : ROT_SPEED);
+        /* Rotation du vecteur direction */
+        float odx = g->p.dir.x;
+        g->p.dir.x = g->p.dir.x * cosf(ang) - g->p.dir.y * sinf(ang);
+        g->p.dir.y = odx          * sinf(ang) + g->p.dir.y * cosf(ang);
+
+        /* Rotation du plan caméra (même angle) */
+        float opx = g->p.plane.x;
+        g->p.plane.x = g->p.plane.x * cosf(ang) - g->p.plane.y * sinf(ang);
+        g->p.plane.y = opx           * sinf(ang) + g->p.plane.y * cosf(ang);
+    }
+
+    /* Déplacement du tick: sens du préchargement du monde en chunks */
+    g->p.vel.x = g->p.pos.x - from.x;
+    g->p.vel.y = g->p.pos.y - from.y;
+
+    /* Pokéballs au contact du joueur */
+    sprite_pickup(g);
+}
+
+static void sky_tick(t_game *g)
+{
+    int off;
+
+    if (SKY_SCROLL_MS <= 0 || !g->tex_sky.addr || g->tex_sky.w <= 0)
+        return ;
+    off = (int)(((clock_ns() / 1000000 - g->sky_t0_ms) / SKY_SCROLL_MS) % g->tex_sky.w);
+    if (off != g->sky_off)
+    {
+        g->sky_off = off;
+        render_invalidate(g, DIRTY_SKY);
+    }
+}
+
+void    loop_start(t_game *g)
+{
+    g->tick = 0;
+    g->sky_t0_ms = clock_ns() / 1000000;
+    render_frame(g);
+    g->dirty = 0;
+}
+
+int     on_expose(t_game *g)
+{
+    render_invalidate(g, DIRTY_EXPOSE);
+    return (0);
+}
+
+int     loop_hook(t_game *g)
+{
+    PROF_END(g, PROF_EVENTS);   /* temps passé dans mlx_loop depuis le dernier appel */
+    TRACE_BEGIN(g, 0, "loop_hook", -1, -1);
+    if (g->want_w > 0 && g->want_h > 0)
+    {
+        /* Redimensionnement demandé: fenêtre (backend) puis écran et tables */
+        if (g->be->resize(g, g->want_w, g->want_h)
+            && !game_resize(g, g->want_w, g->want_h))
+            panic("game_resize failed");
+        g->want_w = 0;
+        g->want_h = 0;
+    }
+    g->tick++;              /* Incrémente un compteur d'itérations de boucle */
+    TRACE_BEGIN(g, 0, "move_and_rotate", -1, -1);
+    move_and_rotate(g);     /* Applique les entrées clavier et met à jour la caméra */
+    TRACE_END(g, 0, "move_and_rotate");
+    /* Monde en chunks: chunks arrivés, recentrage, lectures demandées */
+    if (g->world.active)
+        world_update(g);
+    /* La vue de la dernière frame sert de référence: touche tenue contre un
+       mur = aucun mouvement = rien à redessiner */
+    if (g->p.pos.x != g->view.pos.x || g->p.pos.y != g->view.pos.y
+        || g->p.dir.x != g->view.dir.x || g->p.dir.y != g->view.dir.y
+        || g->p.plane.x != g->view.plane.x || g->p.plane.y != g->view.plane.y)
+        render_invalidate(g, DIRTY_CAMERA);
+    sky_tick(g);
+    if (g->dirty & ~DIRTY_EXPOSE)
+        render_frame(g);    /* Recalcule toute la frame et l'affiche */
+    else if (g->dirty & DIRTY_EXPOSE)
+    {
+        PROF_BEGIN(g, PROF_PRESENT);
+        g->be->present(g);
+        PROF_END(g, PROF_PRESENT);
+    }
+    else
+        usleep(IDLE_SLEEP_US);
+    g->dirty = 0;
+    TRACE_END(g, 0, "loop_hook");
+    TRACE_FLUSH(g);         /* entre deux frames: tampons confiés au thread d'écriture */
+    PROF_BEGIN(g, PROF_EVENTS);
+    return (0);
+}
+
+/* ==========================================================================
+**  Quitter proprement
+**  --------------------------------------------------------------------------
+**  close_window : libère textures, frame, carte, puis le backend (fenêtre, display) et exit
+** ========================================================================== */
+
+int     close_window(t_game *g)
+{
+    pool_destroy(&g->pool);
+    sched_destroy(&g->sched);
+    render_free(g);
+    destroy_tex(g, &g->tex_wall);
+    destroy_tex(g, &g->tex_floor);
+    destroy_tex(g, &g->tex_sky);
+    destroy_tex(g, &tex_pokeball);
+    sprite_runs_free(&pokeball_runs);
+    PROF_REPORT(g);
+    PROF_END(g, PROF_EVENTS);
+    PROF_FREE(g);
+    TRACE_CLOSE(g);
+    destroy_frame(g);
+    map_free(g);
+    g->be->shutdown(g);
+    exit(0);
+    return (0);
+}
+
@@ -0,0 +1,175 @@
+#include "game.h"
+
+/* ==========================================================================
+**  Carte — petite map codée en dur
+**  --------------------------------------------------------------------------
+**  g_small_map : tableau de chaînes représentant la carte (1 = mur, 0 = vide,
+**                C = Pokéball à ramasser)
+**  map_load_rows   : lit un tableau de chaînes (terminé par NULL): largeur
+**                    (map_w), hauteur (map_h), grille à bord plein
+**                    (g->grid) et sprites. Les chaînes ne sont pas gardées.
+**  map_load_file   : même chose depuis un fichier (map_file.c)
+**  grid_alloc      : plans de la grille, toutes cases pleines
+**  grid_derive     : champ de distance + pyramide depuis le plan solid
+**  map_free        : libère la grille, les départs, les sprites et le
+**                    monde en chunks (world_close)
+**  map_set_cell    : change une case (mur / vide) après le chargement
+**  setup_map_small : map_load_rows(g_small_map)
+** ========================================================================== */
+
+static const char *g_small_map[] = {
+    "1111111111111111111111111111111111",
+    "1000000000000000000000000000000001",
+    "100000000C000000000000000000C00001",
+    "1000000000000000000000000000000001",
+    "1000000000000000000000000000000001",
+    "100000000000000C000000000000000001",
+    "1000000000000000000000000000000001",
+    "1000000000000000000000000000000001",
+    "1000111100000000000000000000000001",
+    "1000100000000000000000000C00000001",
+    "1000100111000000000000000000000001",
+    "1000000000000000000000000000000001",
+    "1111111111111111111111111111111111",
+    NULL
+};
+
+/* Plans solid/attr/field d'une carte w × h: bord plein, lignes alignées,
+   toutes les cases pleines (le chargeur vide ensuite les cases libres) */
+int     grid_alloc(t_grid *gr, int w, int h)
+{
+    size_t  size;
+
+    gr->stride = (w + 2 + GRID_ALIGN - 1) & ~(GRID_ALIGN - 1);
+    /* +4 octets de marge: le gather AVX2 lit 32 bits à partir de chaque octet */
+    size = (size_t)gr->stride * (h + 2) + 4;
+    if (posix_memalign((void **)&gr->solid, 64, size)
+        || posix_memalign((void **)&gr->attr, 64, size)
+        || posix_memalign((void **)&gr->field, 64, size))
+        return (0);
+    __builtin_memset(gr->solid, 1, size);
+    __builtin_memset(gr->attr, 0, size);
+    gr->cells = gr->solid + gr->stride + 1;
+    gr->tex = gr->attr + gr->stride + 1;
+    gr->dist = gr->field + gr->stride + 1;
+    return (1);
+}
+
+/* Structures dérivées du plan solid: champ de distance et pyramide */
+int     grid_derive(t_grid *gr, int w, int h)
+{
+    df_build(gr, w, h);
+    return (mip_build(gr, h));
+}
+
+static int  grid_build(t_grid *gr, const char *const *rows, int w, int h)
+{
+    int x;
+    int y;
+
+    if (!grid_alloc(gr, w, h))
+        return (0);
+    y = 0;
+    while (y < h)
+    {
+        /* Lignes plus courtes que w: le reste reste plein */
+        x = 0;
+        while (x < w && rows[y][x])
+        {
+            GRID_SOLID(gr, x, y) = (rows[y][x] == '1');
+            x++;
+        }
+        y++;
+    }
+    return (grid_derive(gr, w, h));
+}
+
+void    map_load_rows(t_game *g, const char *const *rows)
+{
+    int h;
+    int w;
+
+    /* Une carte déjà chargée est remplacée */
+    map_free(g);
+
+    /* Hauteur = nombre de lignes, largeur = la plus longue ligne */
+    h = 0;
+    g->map_w = 0;
+    while (rows[h])
+    {
+        w = 0;
+        while (rows[h][w]) w++;
+        if (w > g->map_w) g->map_w = w;
+        h++;
+    }
+    g->map_h = h;
+
+    /* Grille contiguë à bord plein (DDA sans bornes), attributs, distances */
+    if (!grid_build(&g->grid, rows, g->map_w, g->map_h)) panic("malloc grid");
+    render_invalidate(g, DIRTY_MAP);
+
+    /* Pokéballs posées sur les cases 'C' */
+    sprites_load(g, rows);
+}
+
+void    map_free(t_game *g)
+{
+    world_close(g);
+    free(g->grid.solid);
+    free(g->grid.attr);
+    free(g->grid.field);
+    mip_free(&g->grid);
+    free(g->spawns);
+    g->spawns = NULL;
+    g->spawn_count = 0;
+    sprites_free(g);
+    __builtin_memset(&g->grid, 0, sizeof(g->grid));
+    g->map_w = 0;
+    g->map_h = 0;
+}
+
+/* Une case change après le chargement ('1' = mur, autre = vide): grille,
+   champ de distance et pyramide (mises à jour locales), carte à redessiner */
+void    map_set_cell(t_game *g, int x, int y, char c)
+{
+    if (x < 0 || y < 0 || x >= g->map_w || y >= g->map_h
+        || GRID_SOLID(&g->grid, x, y) == (c == '1'))
+        return ;
+    GRID_SOLID(&g->grid, x, y) = (c == '1');
+    GRID_TEX(&g->grid, x, y) = 0;
+    df_update(&g->grid, g->map_w, g->map_h, x, y);
+    mip_update(&g->grid, x, y);
+    render_invalidate(g, DIRTY_MAP);
+}
+
+void    setup_map_small(t_game *g)
+{
+    map_load_rows(g, g_small_map);
+}
+
+/* ==========================================================================
+**  Player Setup
+**  --------------------------------------------------------------------------
+**  deg_to_rad  : conversion degrés -> radians
+**  setup_player: initialise position, direction et plan caméra (FOV)
+** ========================================================================== */
+
+static float   deg_to_rad(float d) { return d * (float)M_PI / 180.0f; }
+
+void    setup_player(t_game *g, float px, float py, float dir_deg)
+{
+    float a = deg_to_rad(dir_deg);              /* angle initial en radians */
+    float plane_len = tanf(deg_to_rad(g->fov * 0.5f)); /* longueur du plan (FOV/2) */
+
+    /* Centre le joueur au milieu de la case (px,py) */
+    g->p.pos.x = px + 0.5f;
+    g->p.pos.y = py + 0.5f;
+
+    /* Vecteur direction (face où regarde le joueur) */
+    g->p.dir.x = cosf(a);
+    g->p.dir.y = sinf(a);
+
+    /* Vecteur plan caméra (perpendiculaire à dir, définit l'ouverture du FOV) */
+    g->p.plane.x = -g->p.dir.y * plane_len;
+    g->p.plane.y =  g->p.dir.x * plane_len;
+}
@@ -0,0 +1,300 @@
+#include "game.h"
+#include <fcntl.h>      /* open() */
+#include <stdio.h>      /* fprintf() pour les erreurs de format */
+#include <sys/mman.h>   /* mmap(), madvise() */
+#include <sys/stat.h>   /* fstat() */
+#include <unistd.h>     /* close() */
+
+/* ==========================================================================
+**  Fichier de carte (.ber / .cub: la grille seule) — chargeur par mmap
+**  --------------------------------------------------------------------------
+**  Une ligne du fichier = une ligne de cases:
+**    '1' mur   '0' sol   ' ' vide hors carte (plein)   'C' Pokéball
+**    'P' départ (regard +X), 'N' / 'S' / 'E' / 'W' départ orienté
+**  Fins de ligne "\n" ou "\r\n"; lignes de longueurs différentes (le reste
+**  est plein); lignes vides permises seulement à la fin. Au moins un
+**  départ. La carte n'a pas à être fermée: la grille a son propre bord.
+**
+**  Le fichier est projeté en mémoire et lu deux fois, sans copie:
+**    - scan : une passe de validation qui donne largeur, hauteur, nombre
+**             de Pokéballs et de départs (erreur: fichier:ligne:colonne)
+**    - fill : grille allouée à la bonne taille, puis chaque ligne écrite
+**             directement dans le plan solid; sprites et départs relevés
+**             au passage
+**  Les deux passes avancent par mots de 8 octets: un mot fait seulement
+**  de '0' (0x30) et '1' (0x31) se reconnaît à (v & 0xFE..FE) == 0x30..30
+**  et donne ses 8 cases par v & 0x01..01; les autres mots (bords de
+**  ligne, 'C', départs, espaces) passent case par case.
+**
+**  Puis les structures dérivées: champ de distance, pyramide, index des
+**  sprites (grid_derive, sgrid_build).
+**
+**  map_load_file : remplace la carte courante; 0 si le fichier est absent
+**                  ou invalide (message sur stderr), st = octets et temps
+** ========================================================================== */
+
+#define MAP_MAX_SIDE    32000
+#define MAP_ZEROS       0x3030303030303030ull
+#define MAP_LOW_BITS    0x0101010101010101ull
+
+typedef struct s_map_scan
+{
+    const char  *path;
+    const char  *p;         /* fichier projeté */
+    size_t      n;
+    int         w;
+    int         h;
+    int         balls;
+    int         spawns;
+}   t_map_scan;
+
+/* Ligne suivante à partir de *off: longueur sans "\r\n", -1 en fin */
+static long line_next(const t_map_scan *sc, size_t *off, const char **row)
+{
+    const char  *end;
+    size_t      len;
+
+    if (*off >= sc->n)
+        return (-1);
+    *row = sc->p + *off;
+    end = (const char *)memchr(*row, '\n', sc->n - *off);
+    len = end ? (size_t)(end - *row) : sc->n - *off;
+    *off += len + (end != NULL);
+    if (len > 0 && (*row)[len - 1] == '\r')
+        len--;
+    return ((long)len);
+}
+
+/* Erreur à la case (x, y), ou du fichier entier si y < 0 */
+static int  map_error(const t_map_scan *sc, int y, int x, const char *msg)
+{
+    if (y < 0)
+        fprintf(stderr, "poke3d: %s: %s\n", sc->path, msg);
+    else
+        fprintf(stderr, "poke3d: %s:%d:%d: %s\n", sc->path, y + 1, x + 1, msg);
+    return (0);
+}
+
+/* Case hors du chemin rapide: compte 'C' et départs, refuse le reste */
+static int  scan_cell(t_map_scan *sc, char c, int x, int y)
+{
+    if (c == '0' || c == '1' || c == ' ')
+        return (1);
+    if (c == 'C')
+        sc->balls++;
+    else if (c == 'P' || c == 'N' || c == 'S' || c == 'E' || c == 'W')
+        sc->spawns++;
+    else
+    {
+        if (c >= ' ' && c < 127)
+            fprintf(stderr, "poke3d: %s:%d:%d: invalid character '%c'\n",
+                    sc->path, y + 1, x + 1, c);
+        else
+            fprintf(stderr, "poke3d: %s:%d:%d: invalid byte 0x%02x\n",
+                    sc->path, y + 1, x + 1, (unsigned char)c);
+        return (0);
+    }
+    return (1);
+}
+
+static int  scan_row(t_map_scan *sc, const char *r, long len, int y)
+{
+    unsigned long long  v;
+    long                i;
+    long                k;
+
+    i = 0;
+    while (i + 8 <= len)
+    {
+        __builtin_memcpy(&v, r + i, 8);
+        if ((v & ~MAP_LOW_BITS) != MAP_ZEROS)
+        {
+            k = i;
+            while (k < i + 8)
+            {
+                if (!scan_cell(sc, r[k], (int)k, y))
+                    return (0);
+                k++;
+            }
+        }
+        i += 8;
+    }
+    while (i < len)
+    {
+        if (!scan_cell(sc, r[i], (int)i, y))
+            return (0);
+        i++;
+    }
+    return (1);
+}
+
+/* Passe 1: dimensions et comptes, validation complète */
+static int  map_scan(t_map_scan *sc)
+{
+    const char  *row;
+    size_t      off;
+    long        len;
+    int         blank;
+
+    off = 0;
+    blank = -1;
+    while ((len = line_next(sc, &off, &row)) >= 0)
+    {
+        if (len == 0)
+        {
+            if (blank < 0)
+                blank = sc->h;
+            continue ;
+        }
+        if (blank >= 0)
+            return (map_error(sc, blank, 0, "empty line inside the map"));
+        if (len > MAP_MAX_SIDE || sc->h >= MAP_MAX_SIDE)
+            return (map_error(sc, sc->h, 0, "map too large"));
+        if (!scan_row(sc, row, len, sc->h))
+            return (0);
+        if (len > sc->w)
+            sc->w = (int)len;
+        sc->h++;
+    }
+    if (sc->h == 0)
+        return (map_error(sc, -1, 0, "empty map"));
+    if (sc->spawns == 0)
+        return (map_error(sc, -1, 0, "no spawn point (P, N, S, E or W)"));
+    return (1);
+}
+
+/* Case spéciale de la passe 2: sprite, départ ou vide (plein) */
+static unsigned char    fill_cell(t_game *g, char c, int x, int y)
+{
+    t_spawn *s;
+
+    if (c == 'C')
+    {
+        sprites[sprite_count].x = x + 0.5f;
+        sprites[sprite_count].y = y + 0.5f;
+        sprites[sprite_count].active = true;
+        sprite_count++;
+    }
+    else if (c != '0' && c != '1' && c != ' ')
+    {
+        s = &g->spawns[g->spawn_count++];
+        s->x = x;
+        s->y = y;
+        s->deg = (c == 'N') ? 270.0f : (c == 'S') ? 90.0f : (c == 'W') ? 180.0f : 0.0f;
+    }
+    return (c == '1' || c == ' ');
+}
+
+static void fill_row(t_game *g, const char *r, long len, int y)
+{
+    unsigned char       *dst = &GRID_SOLID(&g->grid, 0, y);
+    unsigned long long  v;
+    long                i;
+    long                k;
+
+    i = 0;
+    while (i + 8 <= len)
+    {
+        __builtin_memcpy(&v, r + i, 8);
+        if ((v & ~MAP_LOW_BITS) == MAP_ZEROS)
+        {
+            v &= MAP_LOW_BITS;
+            __builtin_memcpy(dst + i, &v, 8);
+        }
+        else
+        {
+            k = i;
+            while (k < i + 8)
+            {
+                dst[k] = fill_cell(g, r[k], (int)k, y);
+                k++;
+            }
+        }
+        i += 8;
+    }
+    while (i < len)
+    {
+        dst[i] = fill_cell(g, r[i], (int)i, y);
+        i++;
+    }
+}
+
+/* Passe 2: le fichier déjà validé écrit dans la grille (lignes vides de
+   fin ignorées) */
+static void map_fill(t_game *g, const t_map_scan *sc)
+{
+    const char  *row;
+    size_t      off;
+    long        len;
+    int         y;
+
+    off = 0;
+    y = 0;
+    while (y < sc->h && (len = line_next(sc, &off, &row)) >= 0)
+        fill_row(g, row, len, y++);
+}
+
+static int  map_build(t_game *g, t_map_scan *sc, t_map_stats *st)
+{
+    long long   t0;
+
+    t0 = clock_ns();
+    if (!map_scan(sc))
+        return (0);
+    st->scan_ns = clock_ns() - t0;
+    t0 = clock_ns();
+    g->map_w = sc->w;
+    g->map_h = sc->h;
+    g->spawns = (t_spawn *)malloc(sizeof(t_spawn) * sc->spawns);
+    if (!g->spawns || !grid_alloc(&g->grid, sc->w, sc->h))
+        panic("malloc grid");
+    sprites_reserve(g, sc->balls);
+    map_fill(g, sc);
+    st->fill_ns = clock_ns() - t0;
+    t0 = clock_ns();
+    if (!grid_derive(&g->grid, g->map_w, g->map_h))
+        panic("malloc grid");
+    if (sprite_count > 0 && !sgrid_build(g))
+        panic("malloc sprite grid");
+    st->derive_ns = clock_ns() - t0;
+    return (1);
+}
+
+int     map_load_file(t_game *g, const char *path, t_map_stats *st)
+{
+    t_map_scan  sc;
+    struct stat sb;
+    void        *p;
+    int         fd;
+    int         ok;
+
+    __builtin_memset(st, 0, sizeof(*st));
+    __builtin_memset(&sc, 0, sizeof(sc));
+    sc.path = path;
+    map_free(g);
+    fd = open(path, O_RDONLY);
+    if (fd < 0 || fstat(fd, &sb) < 0 || sb.st_size == 0)
+    {
+        if (fd >= 0)
+            close(fd);
+        fprintf(stderr, "poke3d: %s: cannot read map\n", path);
+        return (0);
+    }
+    p = mmap(NULL, (size_t)sb.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (p == MAP_FAILED)
+    {
+        fprintf(stderr, "poke3d: %s: mmap failed\n", path);
+        return (0);
+    }
+    madvise(p, (size_t)sb.st_size, MADV_SEQUENTIAL);
+    sc.p = (const char *)p;
+    sc.n = (size_t)sb.st_size;
+    st->bytes = (long long)sc.n;
+    ok = map_build(g, &sc, st);
+    munmap(p, sc.n);
+    if (!ok)
+        map_free(g);
+    render_invalidate(g, DIRTY_MAP);
+    return (ok);
+}
@@ -0,0 +1,204 @@
+#include "game.h"
+#include <immintrin.h>  /* SSE2: niveaux construits par 16 cases */
+
+/* ==========================================================================
+**  Pyramide d'occupation — DDA hiérarchique pour les grandes cartes
+**  --------------------------------------------------------------------------
+**  Niveau 0 = le plan solid de la grille (bord compris); la case (i, j)
+**  du niveau l est le OU des 2×2 cases (2i..2i+1, 2j..2j+1) du niveau
+**  l - 1: 1 si le bloc de 2^l × 2^l cases du plan contient un mur. Les
+**  cases d'un bloc qui dépassent le niveau du dessous comptent comme
+**  murs. Seul le max sert: un bloc plein de murs n'apprend rien de plus
+**  à la DDA que sa première case.
+**
+**  La DDA garde un niveau courant lv d'un pas à l'autre. mip_block le
+**  descend tant que le bloc de la case est occupé et le remonte tant que
+**  le bloc parent est vide, puis donne les pas libres avant de sortir du
+**  bloc vide (ax en X, ay en Y) pour dda_jump. Les blocs plus petits que
+**  MIP_MIN_LEVEL ne sont pas sautés (un bloc 2×2 épargne au plus un pas):
+**  près des murs lv retombe à 0 et la DDA avance case par case.
+**
+**  mip_build  : tous les niveaux, jusqu'à un plan de 2 × 2 cases au plus
+**               (16 cases à la fois en SSE2 loin du bord du niveau)
+**  mip_update : recalcule les blocs au-dessus d'une case changée
+**  mip_update_rect : même chose pour un rectangle de cases (chunk du monde)
+**  mip_free   : libère les niveaux 1 et plus (mip[0] appartient à la grille)
+**  mip_block  : niveau du plus grand bloc vide autour d'une case + pas libres
+** ========================================================================== */
+
+/* Case (i, j) du niveau l à partir des 2×2 cases du niveau l - 1 */
+static unsigned char    mip_cell(const t_grid *gr, int l, int i, int j)
+{
+    const int   w = gr->mip_w[l - 1];
+    const int   h = gr->mip_h[l - 1];
+    const int   x = 2 * i;
+    const int   y = 2 * j;
+
+    /* Bloc au bord du niveau (taille impaire): la moitié absente est pleine */
+    if (x + 1 >= w || y + 1 >= h)
+        return (1);
+    return (GRID_MIP_AT(gr, l - 1, x, y) | GRID_MIP_AT(gr, l - 1, x + 1, y)
+            | GRID_MIP_AT(gr, l - 1, x, y + 1) | GRID_MIP_AT(gr, l - 1, x + 1, y + 1));
+}
+
+/* Cases [0, n) de la ligne j du niveau l, 16 à la fois: OU des lignes
+   2j et 2j + 1 du niveau l - 1, puis OU des paires d'octets (cases 0 ou
+   1) ramenées à un octet par packus. Seulement les blocs entièrement dans
+   le niveau du dessous; renvoie le nombre de cases faites */
+__attribute__((target("sse2")))
+static int  mip_row_sse(t_grid *gr, int l, int j, int n)
+{
+    const __m128i       low = _mm_set1_epi16(0x00FF);
+    const unsigned char *r0 = &GRID_MIP_AT(gr, l - 1, 0, 2 * j);
+    const unsigned char *r1 = r0 + gr->mip_w[l - 1];
+    unsigned char       *out = &GRID_MIP_AT(gr, l, 0, j);
+    __m128i             a;
+    __m128i             b;
+    int                 i;
+
+    i = 0;
+    while (i + 16 <= n)
+    {
+        a = _mm_or_si128(_mm_loadu_si128((const __m128i *)(r0 + 2 * i)),
+                         _mm_loadu_si128((const __m128i *)(r1 + 2 * i)));
+        b = _mm_or_si128(_mm_loadu_si128((const __m128i *)(r0 + 2 * i + 16)),
+                         _mm_loadu_si128((const __m128i *)(r1 + 2 * i + 16)));
+        a = _mm_and_si128(_mm_or_si128(a, _mm_srli_epi16(a, 8)), low);
+        b = _mm_and_si128(_mm_or_si128(b, _mm_srli_epi16(b, 8)), low);
+        _mm_storeu_si128((__m128i *)(out + i), _mm_packus_epi16(a, b));
+        i += 16;
+    }
+    return (i);
+}
+
+int     mip_build(t_grid *gr, int h)
+{
+    size_t  size;
+    int     l;
+    int     i;
+    int     j;
+
+    mip_free(gr);
+    gr->mip[0] = gr->solid;
+    gr->mip_w[0] = gr->stride;
+    gr->mip_h[0] = h + 2;
+    l = 1;
+    while (l < GRID_MIP && (gr->mip_w[l - 1] > 2 || gr->mip_h[l - 1] > 2))
+    {
+        gr->mip_w[l] = (gr->mip_w[l - 1] + 1) / 2;
+        gr->mip_h[l] = (gr->mip_h[l - 1] + 1) / 2;
+        /* +4 octets de marge: le gather AVX2 lit 32 bits par octet */
+        size = (size_t)gr->mip_w[l] * gr->mip_h[l] + 4;
+        gr->mip[l] = (unsigned char *)malloc(size);
+        if (!gr->mip[l])
+            return (0);
+        gr->mip_levels = l;
+        j = 0;
+        while (j < gr->mip_h[l])
+        {
+            i = 0;
+            if (2 * j + 1 < gr->mip_h[l - 1])
+                i = mip_row_sse(gr, l, j, gr->mip_w[l - 1] / 2);
+            while (i < gr->mip_w[l])
+            {
+                GRID_MIP_AT(gr, l, i, j) = mip_cell(gr, l, i, j);
+                i++;
+            }
+            j++;
+        }
+        l++;
+    }
+    return (1);
+}
+
+void    mip_update(t_grid *gr, int x, int y)
+{
+    int l;
+
+    /* Coordonnées du plan (bord compris) */
+    x++;
+    y++;
+    l = 1;
+    while (l <= gr->mip_levels)
+    {
+        x >>= 1;
+        y >>= 1;
+        GRID_MIP_AT(gr, l, x, y) = mip_cell(gr, l, x, y);
+        l++;
+    }
+}
+
+/* Cases [x0, x1] × [y0, y1] de la carte changées: blocs recalculés niveau
+   par niveau (le rectangle se réduit de moitié à chaque niveau) */
+void    mip_update_rect(t_grid *gr, int x0, int y0, int x1, int y1)
+{
+    int l;
+    int i;
+    int j;
+
+    x0++;
+    y0++;
+    x1++;
+    y1++;
+    l = 1;
+    while (l <= gr->mip_levels)
+    {
+        x0 >>= 1;
+        y0 >>= 1;
+        x1 >>= 1;
+        y1 >>= 1;
+        j = y0;
+        while (j <= y1)
+        {
+            i = x0;
+            while (i <= x1)
+            {
+                GRID_MIP_AT(gr, l, i, j) = mip_cell(gr, l, i, j);
+                i++;
+            }
+            j++;
+        }
+        l++;
+    }
+}
+
+void    mip_free(t_grid *gr)
+{
+    int l;
+
+    l = 1;
+    while (l < GRID_MIP)
+    {
+        free(gr->mip[l]);
+        gr->mip[l++] = NULL;
+    }
+    gr->mip[0] = NULL;
+    gr->mip_levels = 0;
+}
+
+/* Case (x, y) de la carte, pas stx/sty (±1), niveau de départ lv: renvoie
+   le niveau du plus grand bloc vide qui la contient (0 si aucun de niveau
+   MIP_MIN_LEVEL au moins) et les pas libres avant d'en sortir par axe */
+int     mip_block(const t_grid *gr, int x, int y, int stx, int sty, int lv,
+                  int *ax, int *ay)
+{
+    int lo;
+
+    x++;
+    y++;
+    if (lv < MIP_MIN_LEVEL)
+        lv = MIP_MIN_LEVEL - 1;
+    while (lv >= MIP_MIN_LEVEL && GRID_MIP_AT(gr, lv, x >> lv, y >> lv))
+        lv--;
+    while (lv < gr->mip_levels && !GRID_MIP_AT(gr, lv + 1, x >> (lv + 1), y >> (lv + 1)))
+        lv++;
+    *ax = 0;
+    *ay = 0;
+    if (lv < MIP_MIN_LEVEL)
+        return (0);
+    lo = (x >> lv) << lv;
+    *ax = (stx > 0) ? lo + (1 << lv) - 1 - x : x - lo;
+    lo = (y >> lv) << lv;
+    *ay = (sty > 0) ? lo + (1 << lv) - 1 - y : y - lo;
+    return (lv);
+}
@@ -0,0 +1,206 @@
+#include "game.h"
+#include <stdio.h>              /* fprintf() */
+#include <errno.h>
+#include <unistd.h>             /* read(), close(), syscall() */
+#include <sys/syscall.h>        /* SYS_perf_event_open */
+#include <linux/perf_event.h>
+
+/* ==========================================================================
+**  Compteurs matériels par étape (perf_event_open)
+**  --------------------------------------------------------------------------
+**  Build profileur (make PROFILE=1) + POKE3D_PERF=1. Chaque worker ouvre
+**  son propre groupe de compteurs (cycles, instructions, défauts L1D et
+**  LLC en lecture, mauvaises prédictions de branche) sur son thread, à sa
+**  première tuile: pid 0 = thread appelant, donc le worker doit l'ouvrir
+**  lui-même. Une lecture groupée avant et après chaque tuile attribue le
+**  delta à l'étape ouverte (g->prof.stage): on ne compte que le travail,
+**  pas l'attente au bout d'une passe.
+**
+**  Compteurs absents (VM, perf_event_paranoid, CPU sans ce compteur): le
+**  membre est ignoré (valeur -1); sans cycles, le worker ne compte rien.
+**
+**  pmu_init    : un emplacement par worker si POKE3D_PERF est défini
+**  pmu_begin   : instantané des compteurs du worker au début d'une tuile
+**  pmu_end     : delta de la tuile -> compteurs de l'étape ouverte
+**  pmu_collect : somme des workers dans la frame (entre deux frames)
+**  pmu_close   : ferme les compteurs
+** ========================================================================== */
+
+#ifdef POKE3D_PROFILE
+
+static const struct { unsigned int type; unsigned long long config; } g_pmu_ev[PMU_COUNT] = {
+    { PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES },
+    { PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS },
+    { PERF_TYPE_HW_CACHE, PERF_COUNT_HW_CACHE_L1D
+        | (PERF_COUNT_HW_CACHE_OP_READ << 8) | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16) },
+    { PERF_TYPE_HW_CACHE, PERF_COUNT_HW_CACHE_LL
+        | (PERF_COUNT_HW_CACHE_OP_READ << 8) | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16) },
+    { PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES },
+};
+
+static int  pmu_open(int e, int group)
+{
+    struct perf_event_attr  a;
+
+    __builtin_memset(&a, 0, sizeof(a));
+    a.size = sizeof(a);
+    a.type = g_pmu_ev[e].type;
+    a.config = g_pmu_ev[e].config;
+    a.read_format = PERF_FORMAT_GROUP;
+    a.exclude_kernel = 1;
+    a.exclude_hv = 1;
+    return ((int)syscall(SYS_perf_event_open, &a, 0, -1, group, 0));
+}
+
+/* Ouverture paresseuse, sur le thread du worker */
+static void pmu_open_group(t_pmu *m, int worker)
+{
+    int e;
+
+    m->nr = 0;
+    e = 0;
+    while (e < PMU_COUNT)
+    {
+        m->slot[e] = -1;
+        m->fd[e] = pmu_open(e, (e == PMU_CYCLES) ? -1 : m->leader);
+        if (e == PMU_CYCLES)
+            m->leader = m->fd[e];
+        if (m->leader < 0)
+        {
+            if (worker == 0)
+                fprintf(stderr, "poke3d: perf: hardware counters unavailable (%s)\n",
+                        strerror(errno));
+            m->leader = -1;
+            return ;
+        }
+        if (m->fd[e] >= 0)
+            m->slot[e] = m->nr++;
+        e++;
+    }
+}
+
+static int  pmu_read(const t_pmu *m, long long *out)
+{
+    unsigned long long  buf[1 + PMU_COUNT];
+    int                 e;
+
+    if (read(m->leader, buf, sizeof(buf)) < (ssize_t)(sizeof(buf[0]) * (1 + m->nr)))
+        return (0);
+    e = 0;
+    while (e < PMU_COUNT)
+    {
+        out[e] = (m->slot[e] >= 0) ? (long long)buf[1 + m->slot[e]] : 0;
+        e++;
+    }
+    return (1);
+}
+
+void    pmu_init(t_game *g)
+{
+    const char  *env = getenv("POKE3D_PERF");
+    int         i;
+
+    g->prof.pmu = NULL;
+    g->prof.npmu = 0;
+    if (!env || !*env || *env == '0')
+        return ;
+    g->prof.pmu = (t_pmu *)calloc(g->pool.count, sizeof(t_pmu));
+    if (!g->prof.pmu)
+        return ;
+    g->prof.npmu = g->pool.count;
+    i = 0;
+    while (i < g->prof.npmu)
+        g->prof.pmu[i++].leader = -2;
+}
+
+void    pmu_begin(t_game *g, int worker)
+{
+    t_pmu   *m = &g->prof.pmu[worker];
+
+    if (m->leader == -2)
+        pmu_open_group(m, worker);
+    if (m->leader >= 0 && !pmu_read(m, m->start))
+        m->start[PMU_CYCLES] = -1;
+}
+
+void    pmu_end(t_game *g, int worker)
+{
+    t_pmu       *m = &g->prof.pmu[worker];
+    long long   now[PMU_COUNT];
+    int         e;
+
+    if (m->leader < 0 || m->start[PMU_CYCLES] < 0 || !pmu_read(m, now))
+        return ;
+    e = 0;
+    while (e < PMU_COUNT)
+    {
+        m->acc[g->prof.stage][e] += now[e] - m->start[e];
+        e++;
+    }
+}
+
+/* Somme d'un compteur sur les workers qui comptent (-1 si l'un d'eux ne
+   l'a pas, ou si aucun ne compte) */
+static long long    pmu_sum(const t_game *g, int s, int e)
+{
+    const t_pmu *m;
+    long long   sum;
+    int         w;
+
+    sum = -1;
+    w = 0;
+    while (w < g->prof.npmu)
+    {
+        m = &g->prof.pmu[w++];
+        if (m->leader < 0)
+            continue ;
+        if (m->slot[e] < 0)
+            return (-1);
+        sum = (sum < 0 ? 0 : sum) + m->acc[s][e];
+    }
+    return (sum);
+}
+
+/* Thread principal, workers au repos: les accumulateurs ne bougent pas */
+void    pmu_collect(t_game *g, t_prof_frame *f)
+{
+    int s;
+    int e;
+    int w;
+
+    s = 0;
+    while (s < PROF_COUNT)
+    {
+        e = 0;
+        while (e < PMU_COUNT)
+        {
+            f->pmu[s][e] = pmu_sum(g, s, e);
+            e++;
+        }
+        s++;
+    }
+    w = 0;
+    while (w < g->prof.npmu)
+        __builtin_memset(g->prof.pmu[w++].acc, 0, sizeof(g->prof.pmu[0].acc));
+}
+
+void    pmu_close(t_game *g)
+{
+    int w;
+    int e;
+
+    w = 0;
+    while (g->prof.pmu && w < g->prof.npmu)
+    {
+        e = PMU_COUNT;
+        while (g->prof.pmu[w].leader >= 0 && e-- > 0)
+            if (g->prof.pmu[w].fd[e] >= 0)
+                close(g->prof.pmu[w].fd[e]);
+        w++;
+    }
+    free(g->prof.pmu);
+    g->prof.pmu = NULL;
+    g->prof.npmu = 0;
+}
+
+#endif
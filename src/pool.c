@@ -0,0 +1,148 @@
+#include "game.h"
+#include <stdio.h>    /* fprintf() pour les avertissements */
+
+/* ==========================================================================
+**  Pool de threads persistant
+**  --------------------------------------------------------------------------
+**  render_thread_count : nombre de workers voulu (RENDER_THREADS / env / cœurs)
+**  pool_init    : crée count-1 threads qui attendent un job (le principal = worker 0)
+**  pool_run     : publie un job, l'exécute aussi sur le thread appelant,
+**                 puis attend que tous les workers aient terminé (join de frame)
+**  pool_destroy : réveille les workers avec quit=true et les rejoint
+**
+**  Les threads sont créés UNE fois: pool_run ne fait qu'un broadcast sur une
+**  condition, bien moins coûteux qu'un pthread_create par frame.
+** ========================================================================== */
+
+int     render_thread_count(void)
+{
+    const char  *env;
+    long        n;
+
+    /* Priorité: variable d'environnement, puis constante, puis nb de cœurs */
+    n = RENDER_THREADS;
+    env = getenv("POKE3D_THREADS");
+    if (env && *env)
+        n = strtol(env, NULL, 10);
+    if (n <= 0)
+        n = sysconf(_SC_NPROCESSORS_ONLN);
+    if (n < 1) n = 1;
+    if (n > MAX_THREADS) n = MAX_THREADS;
+    return ((int)n);
+}
+
+static void *worker_main(void *p)
+{
+    t_worker_arg    *wa = (t_worker_arg *)p;
+    t_pool          *pool = wa->pool;
+    unsigned        seen = 0;
+
+    pthread_mutex_lock(&pool->lock);
+    while (1)
+    {
+        /* Dort jusqu'à ce qu'une nouvelle génération de job soit publiée */
+        while (!pool->quit && pool->generation == seen)
+            pthread_cond_wait(&pool->wake, &pool->lock);
+        if (pool->quit)
+            break ;
+        seen = pool->generation;
+        pthread_mutex_unlock(&pool->lock);
+
+        pool->job(pool->arg, wa->id, pool->count);
+
+        pthread_mutex_lock(&pool->lock);
+        /* Le dernier worker à finir réveille le thread principal */
+        if (--pool->pending == 0)
+            pthread_cond_signal(&pool->done);
+    }
+    pthread_mutex_unlock(&pool->lock);
+    return (NULL);
+}
+
+int     pool_init(t_pool *pool, int count)
+{
+    int i;
+
+    __builtin_memset(pool, 0, sizeof(*pool));
+    if (count < 1) count = 1;
+    if (count > MAX_THREADS) count = MAX_THREADS;
+    pool->count = count;
+    if (pthread_mutex_init(&pool->lock, NULL)
+        || pthread_cond_init(&pool->wake, NULL)
+        || pthread_cond_init(&pool->done, NULL))
+        return (0);
+    pool->threads = (pthread_t *)malloc(sizeof(pthread_t) * count);
+    pool->args = (t_worker_arg *)malloc(sizeof(t_worker_arg) * count);
+    if (!pool->threads || !pool->args)
+    {
+        free(pool->threads);
+        free(pool->args);
+        pool->threads = NULL;
+        pool->args = NULL;
+        return (0);
+    }
+    /* Worker 0 = thread appelant: on ne crée que les workers 1..count-1 */
+    i = 1;
+    while (i < count)
+    {
+        pool->args[i].pool = pool;
+        pool->args[i].id = i;
+        if (pthread_create(&pool->threads[i], NULL, worker_main, &pool->args[i]))
+        {
+            /* Échec partiel: on garde les threads déjà lancés */
+            fprintf(stderr, "poke3d: pthread_create failed, %d worker(s)\n", i);
+            pool->count = i;
+            break ;
+        }
+        i++;
+    }
+    return (1);
+}
+
+void    pool_run(t_pool *pool, t_job job, void *arg)
+{
+    /* Un seul worker: pas de synchronisation du tout */
+    if (pool->count <= 1)
+    {
+        job(arg, 0, 1);
+        return ;
+    }
+    pthread_mutex_lock(&pool->lock);
+    pool->job = job;
+    pool->arg = arg;
+    pool->pending = pool->count - 1;
+    pool->generation++;
+    pthread_cond_broadcast(&pool->wake);
+    pthread_mutex_unlock(&pool->lock);
+
+    /* Le thread principal travaille aussi (worker 0) */
+    job(arg, 0, pool->count);
+
+    /* Barrière de fin: attend que tous les workers aient rendu leur part */
+    pthread_mutex_lock(&pool->lock);
+    while (pool->pending > 0)
+        pthread_cond_wait(&pool->done, &pool->lock);
+    pthread_mutex_unlock(&pool->lock);
+}
+
+void    pool_destroy(t_pool *pool)
+{
+    int i;
+
+    if (!pool->threads)
+        return ;
+    pthread_mutex_lock(&pool->lock);
+    pool->quit = true;
+    pthread_cond_broadcast(&pool->wake);
+    pthread_mutex_unlock(&pool->lock);
+    i = 1;
+    while (i < pool->count)
+        pthread_join(pool->threads[i++], NULL);
+    free(pool->threads);
+    free(pool->args);
+    pool->threads = NULL;
+    pool->args = NULL;
+    pthread_mutex_destroy(&pool->lock);
+    pthread_cond_destroy(&pool->wake);
+    pthread_cond_destroy(&pool->done);
+}
@@ -0,0 +1,349 @@
+#include "game.h"
+#include <stdio.h>    /* fprintf() pour le rapport */
+
+/* ==========================================================================
+**  Profileur par étape + surcouche à l'écran
+**  --------------------------------------------------------------------------
+**  Compilé seulement avec -DPOKE3D_PROFILE (make PROFILE=1). Sans ce flag,
+**  les macros PROF_* de game.h sont vides et ce fichier ne contient rien.
+**  Avec -DPOKE3D_TRACE, les mêmes bornes d'étape émettent aussi des
+**  événements de trace (trace.c) sur le thread principal.
+**
+**  Chaque étape (DDA, ciel, sol, murs, transposition, agrandissement,
+**  present) est encadrée par PROF_BEGIN / PROF_END sur le thread principal:
+**  render_pass ne rend la main qu'une fois la passe finie sur tous les
+**  workers, on mesure donc le temps mur de l'étape. PROF_EVENTS couvre le
+**  temps passé hors de loop_hook (drain des événements X et XSync de
+**  mlx_loop). PROF_FRAME_END range la frame dans l'anneau.
+**
+**  prof_init      : surcouche visible d'emblée si POKE3D_PROFILE_OVERLAY=1
+**  prof_begin/end : ouvre / ferme une étape (les durées s'additionnent)
+**  prof_frame_end : frame courante -> anneau, intervalle depuis la précédente
+**  prof_overlay   : barres par étape + graphe des frames dans g->frame
+**  prof_last      : dernière frame rangée (bench: compteurs par frame)
+**  prof_report    : moyennes de l'anneau sur stderr (+ IPC, défauts/pixel)
+** ========================================================================== */
+
+#if defined(POKE3D_PROFILE) || defined(POKE3D_TRACE)
+
+static const char   *g_prof_names[PROF_COUNT] = {
+    "events", "dda", "sky", "floor", "walls", "transpose", "upscale", "present",
+    "sprites"
+};
+
+void    prof_begin(t_game *g, int id)
+{
+# ifdef POKE3D_PROFILE
+    g->prof.t0[id] = clock_ns();
+    g->prof.stage = id;     /* publié aux workers par le prochain pool_run */
+# endif
+# ifdef POKE3D_TRACE
+    g->trace.open |= 1u << id;
+    TRACE_BEGIN(g, 0, g_prof_names[id], -1, -1);
+# endif
+}
+
+void    prof_end(t_game *g, int id)
+{
+    /* Étape jamais ouverte (premier loop_hook pour PROF_EVENTS): ignorée */
+# ifdef POKE3D_PROFILE
+    if (g->prof.t0[id] != 0)
+        g->prof.cur.ns[id] += clock_ns() - g->prof.t0[id];
+    g->prof.t0[id] = 0;
+# endif
+# ifdef POKE3D_TRACE
+    if (g->trace.open & (1u << id))
+        TRACE_END(g, 0, g_prof_names[id]);
+    g->trace.open &= ~(1u << id);
+# endif
+}
+
+#endif
+
+#ifdef POKE3D_PROFILE
+
+static const int    g_prof_colors[PROF_COUNT] = {
+    0x808080, 0xE04040, 0x40A0E0, 0x40C040, 0xE0A030, 0xA060E0, 0x30D0C0, 0xE0E040,
+    0xF070C0
+};
+
+void    prof_init(t_game *g)
+{
+    const char  *env = getenv("POKE3D_PROFILE_OVERLAY");
+
+    __builtin_memset(&g->prof, 0, sizeof(g->prof));
+    g->prof.overlay = (env && *env && *env != '0');
+    pmu_init(g);
+}
+
+void    prof_frame_end(t_game *g)
+{
+    t_prof      *p = &g->prof;
+    long long   now = clock_ns();
+
+    pmu_collect(g, &p->cur);
+    p->cur.pixels = (long long)g->frame.w * g->frame.h;
+    p->cur.frame_ns = (p->last_ns > 0) ? now - p->last_ns : 0;
+    p->last_ns = now;
+    p->ring[p->head] = p->cur;
+    p->head = (p->head + 1) % PROF_RING;
+    if (p->count < PROF_RING)
+        p->count++;
+    __builtin_memset(&p->cur, 0, sizeof(p->cur));
+}
+
+const t_prof_frame  *prof_last(const t_game *g)
+{
+    if (g->prof.count == 0)
+        return (NULL);
+    return (&g->prof.ring[(g->prof.head - 1 + PROF_RING) % PROF_RING]);
+}
+
+/* Compteur e de l'étape s (s = PROF_COUNT: toutes) sommé sur l'anneau;
+   -1 si le compteur manque dans une frame */
+static long long    prof_pmu_sum(const t_prof *p, int s, int e)
+{
+    long long   sum;
+    long long   v;
+    int         i;
+    int         k;
+
+    sum = 0;
+    i = 0;
+    while (i < p->count)
+    {
+        k = (s < PROF_COUNT) ? s : 0;
+        while (k < PROF_COUNT && (k == s || s == PROF_COUNT))
+        {
+            v = p->ring[i].pmu[k++][e];
+            if (v < 0)
+                return (-1);
+            sum += v;
+        }
+        i++;
+    }
+    return (sum);
+}
+
+/* Moyenne par étape sur l'anneau (ms) */
+static void prof_avg(const t_prof *p, double *ms)
+{
+    int i;
+    int s;
+
+    s = 0;
+    while (s < PROF_COUNT)
+        ms[s++] = 0.0;
+    if (p->count == 0)
+        return ;
+    i = 0;
+    while (i < p->count)
+    {
+        s = 0;
+        while (s < PROF_COUNT)
+        {
+            ms[s] += p->ring[i].ns[s] / 1e6;
+            s++;
+        }
+        i++;
+    }
+    s = 0;
+    while (s < PROF_COUNT)
+        ms[s++] /= p->count;
+}
+
+static void rect(t_img *img, int x, int y, int w, int h, int color)
+{
+    int i;
+
+    i = 0;
+    while (i < h)
+        span_fill_h(img, y + i++, x, x + w, color);
+}
+
+/* Assombrit le fond du panneau (lisible sur n'importe quelle scène) */
+static void shade(t_img *img, int x, int y, int w, int h)
+{
+    unsigned int    *p;
+    int             i;
+    int             j;
+
+    if (x < 0) { w += x; x = 0; }
+    if (y < 0) { h += y; y = 0; }
+    if (x + w > img->w) w = img->w - x;
+    if (y + h > img->h) h = img->h - y;
+    i = 0;
+    while (i < h)
+    {
+        p = img->rows[y + i] + (size_t)x * img->xstep;
+        j = 0;
+        while (j < w)
+        {
+            p[(size_t)j * img->xstep] = (p[(size_t)j * img->xstep] >> 2) & 0x3F3F3F;
+            j++;
+        }
+        i++;
+    }
+}
+
+/* Compteurs matériels, une ligne par étape: IPC (couleur de l'étape,
+   pleine largeur = 4) et défauts L1D par pixel (blanc, pleine largeur = 1) */
+static void overlay_pmu(const t_prof *p, t_img *img, int y, int bw)
+{
+    long long   cyc;
+    long long   px;
+    double      v;
+    int         s;
+    int         i;
+
+    px = 0;
+    i = 0;
+    while (i < p->count)
+        px += p->ring[i++].pixels;
+    s = 0;
+    while (s < PROF_COUNT)
+    {
+        rect(img, 8, y, 4, 5, g_prof_colors[s]);
+        cyc = prof_pmu_sum(p, s, PMU_CYCLES);
+        v = (cyc > 0) ? (double)prof_pmu_sum(p, s, PMU_INSTR) / cyc / 4.0 : 0.0;
+        rect(img, 16, y, (int)((v > 1.0 ? 1.0 : v) * (bw - 8)), 3, g_prof_colors[s]);
+        v = (px > 0) ? (double)prof_pmu_sum(p, s, PMU_L1D_MISS) / px : 0.0;
+        rect(img, 16, y + 3, (int)((v > 1.0 ? 1.0 : v) * (bw - 8)), 2, 0xFFFFFF);
+        y += 8;
+        s++;
+    }
+}
+
+/* Panneau en haut à gauche: une barre par étape (longueur = ms moyennes,
+   pleine largeur = budget de frame), une barre empilée de la frame entière,
+   puis le graphe des intervalles entre frames (vert sous le budget, rouge
+   au-dessus, ligne blanche = budget), et les compteurs matériels s'ils
+   sont actifs. */
+void    prof_overlay(t_game *g)
+{
+    const t_prof    *p = &g->prof;
+    t_img           *img = &g->frame;
+    double          budget = g->drs.last.target_ms > 0.0 ? g->drs.last.target_ms : DRS_TARGET_MS;
+    double          ms[PROF_COUNT];
+    int             bw;
+    int             ph;
+    int             x;
+    int             y;
+    int             s;
+    int             i;
+    int             v;
+
+    if (!p->overlay || !img->rows)
+        return ;
+    bw = (img->w - 24 < 256) ? img->w - 24 : 256;
+    ph = 8 * PROF_COUNT + 76;
+    if (prof_pmu_sum(p, PROF_COUNT, PMU_CYCLES) >= 0)
+        ph += 8 * PROF_COUNT + 4;
+    if (bw < 32 || img->h < ph + 4)
+        return ;
+    prof_avg(p, ms);
+    shade(img, 4, 4, bw + 16, ph);
+    /* Barres par étape, légende = carré de couleur */
+    s = 0;
+    while (s < PROF_COUNT)
+    {
+        y = 10 + s * 8;
+        rect(img, 8, y, 4, 5, g_prof_colors[s]);
+        v = (int)(ms[s] / budget * (bw - 8));
+        rect(img, 16, y, v > bw - 8 ? bw - 8 : v, 5, g_prof_colors[s]);
+        s++;
+    }
+    /* Frame entière, étapes empilées */
+    y = 14 + PROF_COUNT * 8;
+    x = 8;
+    s = 0;
+    while (s < PROF_COUNT && x < 8 + bw)
+    {
+        v = (int)(ms[s] / budget * bw);
+        rect(img, x, y, (x + v > 8 + bw) ? 8 + bw - x : v, 6, g_prof_colors[s]);
+        x += v;
+        s++;
+    }
+    /* Graphe: 48 px = 2 budgets, une colonne de 2 px par frame */
+    y += 12;
+    i = 0;
+    while (i < p->count && i * 2 < bw)
+    {
+        const t_prof_frame  *f = &p->ring[(p->head - 1 - i + PROF_RING) % PROF_RING];
+
+        v = (int)(f->frame_ns / 1e6 / budget * 24);
+        if (v > 48) v = 48;
+        rect(img, 8 + bw - 2 - i * 2, y + 48 - v, 2, v,
+             (f->frame_ns / 1e6 > budget) ? 0xE04040 : 0x40C040);
+        i++;
+    }
+    rect(img, 8, y + 24, bw, 1, 0xFFFFFF);
+    if (ph > 8 * PROF_COUNT + 76)
+        overlay_pmu(p, img, y + 56, bw);
+}
+
+/* Fin de ligne du rapport: IPC et événements par pixel de la cible */
+static void report_pmu(const t_prof *p, int s)
+{
+    static const char   *names[PMU_COUNT] = { NULL, NULL, "L1D", "LLC", "br" };
+    long long           px;
+    long long           cyc;
+    long long           v;
+    int                 e;
+    int                 i;
+
+    cyc = prof_pmu_sum(p, s, PMU_CYCLES);
+    if (cyc <= 0)
+    {
+        fprintf(stderr, "\n");
+        return ;
+    }
+    px = 0;
+    i = 0;
+    while (i < p->count)
+        px += p->ring[i++].pixels;
+    v = prof_pmu_sum(p, s, PMU_INSTR);
+    if (v >= 0)
+        fprintf(stderr, "  IPC %5.2f", (double)v / cyc);
+    e = PMU_L1D_MISS;
+    while (e < PMU_COUNT)
+    {
+        v = prof_pmu_sum(p, s, e);
+        if (v >= 0 && px > 0)
+            fprintf(stderr, "  %s %.4f/px", names[e], (double)v / px);
+        e++;
+    }
+    fprintf(stderr, "\n");
+}
+
+void    prof_report(const t_game *g)
+{
+    const t_prof    *p = &g->prof;
+    double          ms[PROF_COUNT];
+    double          sum;
+    double          fr;
+    int             i;
+    int             s;
+
+    if (p->count == 0)
+        return ;
+    prof_avg(p, ms);
+    fr = 0.0;
+    i = 0;
+    while (i < p->count)
+        fr += p->ring[i++].frame_ns / 1e6;
+    fr /= p->count;
+    sum = 0.0;
+    fprintf(stderr, "profile: last %d frames, %.3f ms between frames\n", p->count, fr);
+    s = 0;
+    while (s < PROF_COUNT)
+    {
+        fprintf(stderr, "  %-10s %8.3f ms", g_prof_names[s], ms[s]);
+        report_pmu(p, s);
+        sum += ms[s++];
+    }
+    fprintf(stderr, "  %-10s %8.3f ms", "total", sum);
+    report_pmu(p, PROF_COUNT);
+}
+
+#endif
@@ -0,0 +1,516 @@
+#include "game.h"
+#include <limits.h>     /* INT_MAX */
+
+/* ==========================================================================
+**  Rendu par étages (pipeline)
+**  --------------------------------------------------------------------------
+**  Une frame est construite en passes successives sur TOUTES les colonnes:
+**    1) stage_hits  : DDA par paquets + bornes de la bande mur de chaque colonne
+**    2) stage_sky   : ciel texturé au-dessus de draw_start (tables tx/ty)
+**    3) stage_floor : sol (floor casting ligne par ligne) sous draw_end
+**    4) stage_walls : bande de mur texturée [draw_start, draw_end]
+**    5) stage_sprites : billboards des Pokéballs (sprite.c), après les murs
+**  Chaque passe est une boucle serrée sur un seul working set (rayons, puis
+**  texture de ciel, puis sol, puis mur) qu'on peut mesurer et paralléliser
+**  seule: render_pass la découpe en tuiles pour le scheduler work-stealing.
+**
+**  clampi / wrapi : helpers d'échantillonnage de texture
+**  render_alloc : alloue les tables par colonne / par ligne pour un écran w×h
+** ========================================================================== */
+
+static inline int  clampi(int v, int lo, int hi)
+{
+    if (v < lo) return lo;
+    if (v > hi) return hi;
+    return v;
+}
+
+static inline int  wrapi(int v, int m)
+{
+    int r;
+
+    /* Gestion de cas pathologique (évite division par 0) */
+    if (m <= 0) return 0;
+    /* Modulo classique, puis on s'assure d'un résultat positif */
+    r = v % m;
+    if (r < 0) r += m;
+    return r;
+}
+
+int     render_alloc(t_game *g, int w, int h)
+{
+    t_floor_rows    *fr = &g->floor_rows;
+
+    render_free(g);
+    if (!hits_alloc(&g->hits, w))
+        return (0);
+    zbuf = g->hits.perp_dist;   /* z-buffer des sprites = distance par colonne */
+    fr->base_x = (unsigned int *)malloc(sizeof(unsigned int) * h);
+    fr->base_y = (unsigned int *)malloc(sizeof(unsigned int) * h);
+    fr->step_x = (int *)malloc(sizeof(int) * h);
+    fr->step_y = (int *)malloc(sizeof(int) * h);
+    fr->shade = (int *)malloc(sizeof(int) * h);
+    if (!fr->base_x || !fr->base_y || !fr->step_x || !fr->step_y || !fr->shade)
+        return (0);
+    fr->count = h;
+    /* Tables du ciel: invalidées (seront reconstruites à la prochaine frame) */
+    g->sky.tx = (int *)malloc(sizeof(int) * w);
+    g->sky.ty = (int *)malloc(sizeof(int) * h);
+    if (!g->sky.tx || !g->sky.ty)
+        return (0);
+    return (1);
+}
+
+void    render_free(t_game *g)
+{
+    t_floor_rows    *fr = &g->floor_rows;
+
+    hits_free(&g->hits);
+    zbuf = NULL;
+    free(fr->base_x);
+    free(fr->base_y);
+    free(fr->step_x);
+    free(fr->step_y);
+    free(fr->shade);
+    __builtin_memset(fr, 0, sizeof(*fr));
+    free(g->sky.tx);
+    free(g->sky.ty);
+    colfb_free(g);
+    __builtin_memset(&g->sky, 0, sizeof(g->sky));
+}
+
+/* ---------- 1) Impacts: DDA + hauteur de bande ---------- */
+
+void    stage_hits(t_game *g, int x0, int x1)
+{
+    const int   h = g->view.h;
+    t_hits      *hs = &g->hits;
+    int         x;
+
+    /* Tous les rayons de la tuile d'un coup (paquets SIMD) */
+    g->dda(g, &g->view, x0, x1, hs);
+    x = x0;
+    while (x < x1)
+    {
+        /* Taille de la bande verticale (plus le mur est proche, plus c'est haut).
+           perp_dist descend à 1e-6 contre une face: bornée en float avant la
+           conversion (h / 1e-6 sort des int dès h = 2160) */
+        int line_h = (int)fminf(h / hs->perp_dist[x], (float)INT_MAX / 2);
+        /* Y de début/fin de la bande mur (centrage vertical), borné à l'écran */
+        int draw_start = -line_h / 2 + h / 2;
+        int draw_end   =  line_h / 2 + h / 2;
+        if (draw_start < 0) draw_start = 0;
+        if (draw_end >= h) draw_end = h - 1;
+        hs->line_h[x] = line_h;
+        hs->draw_start[x] = draw_start;
+        hs->draw_end[x] = draw_end;
+        x++;
+    }
+}
+
+/* ---------- 2) Ciel texturé (panorama horizontal + léger défilement) ----------
+   Plus aucun atan2f ni division dans la boucle chaude: sky_lut_update
+   prépare tx (par colonne, seulement si la caméra a tourné) et ty (par
+   ligne, une fois par taille d'écran). Le défilement est un simple décalage
+   ajouté à tx. La passe parcourt ensuite le ciel ligne par ligne: un gather
+   dans UNE ligne de texture, écritures contiguës dans le framebuffer. */
+
+void    sky_lut_update(t_game *g)
+{
+    const t_view    *v = &g->view;
+    t_sky_lut       *s = &g->sky;
+    const int       tw = g->tex_sky.w;
+    const int       th = g->tex_sky.h;
+    int             i;
+
+    if (!g->tex_sky.addr)
+        return ;
+    /* ty: ne dépend que de la hauteur d'écran et de la texture */
+    if (s->ty_h != v->h || s->ty_th != th)
+    {
+        /* Horizon: plus grand => horizon plus bas (plus de ciel visible en haut) */
+        const float horizon_y = v->h * 0.70f; /* ajuste 0.60..0.75 pour placer l'horizon */
+        i = 0;
+        while (i < v->h)
+        {
+            /* v01 mappe la hauteur écran vers la hauteur texture du ciel */
+            int ty = (int)((float)i / horizon_y * (float)th);
+            s->ty[i++] = clampi(ty, 0, th - 1);
+        }
+        s->ty_h = v->h;
+        s->ty_th = th;
+    }
+    /* tx: seulement si la caméra a tourné (dir/plane) ou si la taille a changé */
+    if (s->tx_w == v->w && s->tx_tw == tw
+        && s->dir.x == v->dir.x && s->dir.y == v->dir.y
+        && s->plane.x == v->plane.x && s->plane.y == v->plane.y)
+        return ;
+    i = 0;
+    while (i < v->w)
+    {
+        float x_cam = 2.0f * i / (float)v->w - 1.0f;
+        /* Direction du rayon -> angle (-pi..pi) -> [0..1) -> colonne de texture */
+        float ang = atan2f(v->dir.y + v->plane.y * x_cam, v->dir.x + v->plane.x * x_cam);
+        float u01 = (ang / (2.0f * (float)M_PI)) + 0.5f;
+        s->tx[i++] = wrapi((int)(u01 * (float)tw), tw);
+    }
+    s->dir = v->dir;
+    s->plane = v->plane;
+    s->tx_w = v->w;
+    s->tx_tw = tw;
+}
+
+void    stage_sky(t_game *g, int x0, int x1)
+{
+    const int   *draw_start = g->hits.draw_start;
+    const int   *tx = g->sky.tx;
+    const int   tw = g->tex_sky.w;
+    const int   off = g->view.sky_off;
+    int         y_end;
+    int         y;
+    int         x;
+
+    /* Dernière ligne de ciel de la tuile = au-dessus du plus haut des murs */
+    y_end = 0;
+    x = x0;
+    while (x < x1)
+    {
+        if (draw_start[x] > y_end) y_end = draw_start[x];
+        x++;
+    }
+    y = 0;
+    while (y < y_end)
+    {
+        unsigned int    *row = g->frame.rows[y];
+        int             a;
+
+        /* Parcours par segments: [a, x) = colonnes encore dans le ciel */
+        x = x0;
+        while (x < x1)
+        {
+            while (x < x1 && y >= draw_start[x])
+                x++;
+            a = x;
+            while (x < x1 && y < draw_start[x])
+                x++;
+            if (a == x)
+                continue ;
+            if (!g->tex_sky.addr)
+            {
+                /* Fallback : si pas de texture ciel, on remplit le haut avec un bleu */
+                span_fill_h(&g->frame, y, a, x, rgb(120,180,255));
+                continue ;
+            }
+            /* Une seule ligne de texture par ligne d'écran */
+            const unsigned int *src = (const unsigned int *)(g->tex_sky.addr
+                                        + g->sky.ty[y] * g->tex_sky.line_len);
+            while (a < x)
+            {
+                int u = tx[a] + off;
+                if (u >= tw) u -= tw;
+                row[a++] = src[u];
+            }
+        }
+        y++;
+    }
+}
+
+/* ---------- 3) Sol texturé (floor casting par lignes) ----------
+   rowDist, position monde au bord gauche, pas par colonne et ombrage ne
+   dépendent QUE de la ligne y: floor_rows_update les calcule une fois par
+   frame. La passe parcourt ensuite chaque ligne de gauche à droite avec de
+   simples additions entières (16.16), en sautant les colonnes encore
+   couvertes par le mur (y <= draw_end[x]). Écritures contiguës par ligne. */
+
+void    floor_rows_update(t_game *g)
+{
+    const t_view    *v = &g->view;
+    t_floor_rows    *fr = &g->floor_rows;
+    const int       h = v->h;
+    /* Directions des rayons aux extrémités gauche/droite de l'écran */
+    const float     dir0x = v->dir.x - v->plane.x;
+    const float     dir0y = v->dir.y - v->plane.y;
+    const float     dir1x = v->dir.x + v->plane.x;
+    const float     dir1y = v->dir.y + v->plane.y;
+    /* Position "caméra" en Z = moitié de la hauteur d'écran (convention) */
+    const float     posZ = 0.5f * (float)h;
+    int             y;
+
+    /* Le sol commence sous draw_end >= h / 2: la ligne de l'horizon n'est
+       jamais dessinée (rowDist y serait infini, les pas hors des int) */
+    y = h / 2 + 1;
+    while (y < h)
+    {
+        /* p = distance verticale (pixels) entre la ligne y et l'horizon (centre) */
+        float p = (float)y - (float)h / 2.0f;
+        /* rowDist = distance au plan du sol correspondant à la ligne y */
+        float rowDist = posZ / p;
+
+        fr->base_x[y] = (unsigned int)(long long)floor(
+            (v->pos.x + rowDist * dir0x) * 65536.0);
+        fr->base_y[y] = (unsigned int)(long long)floor(
+            (v->pos.y + rowDist * dir0y) * 65536.0);
+        fr->step_x[y] = (int)(rowDist * (dir1x - dir0x) / (float)v->w * 65536.0f);
+        fr->step_y[y] = (int)(rowDist * (dir1y - dir0y) / (float)v->w * 65536.0f);
+        /* Assombrissement doux avec la distance: 1 / (1 + k * d^2) */
+        fr->shade[y] = (int)(256.0f / (1.0f + 0.02f * rowDist * rowDist));
+        y++;
+    }
+}
+
+/* Multiplie R, G et B par s/256 (s <= 256) en deux multiplications:
+   R et B partagent un mot (0x00FF00FF), G est traité à part. */
+static inline int  shade_color(int c, int s)
+{
+    unsigned int rb = (((unsigned int)c & 0xFF00FF) * s >> 8) & 0xFF00FF;
+    unsigned int gg = (((unsigned int)c & 0x00FF00) * s >> 8) & 0x00FF00;
+
+    return ((int)(rb | gg));
+}
+
+void    stage_floor(t_game *g, int x0, int x1)
+{
+    const t_floor_rows  *fr = &g->floor_rows;
+    const int           *draw_end = g->hits.draw_end;
+    const t_tex         *t = &g->tex_floor;
+    const int           h = g->view.h;
+    int                 y;
+    int                 x;
+
+    /* Première ligne de sol de la tuile = sous le plus bas des murs */
+    y = h;
+    x = x0;
+    while (x < x1)
+    {
+        if (draw_end[x] + 1 < y) y = draw_end[x] + 1;
+        x++;
+    }
+    if (!t->addr)
+    {
+        /* Fallback : si pas de texture sol, on remplit la zone basse en vert */
+        while (y < h)
+        {
+            int a;
+
+            x = x0;
+            while (x < x1)
+            {
+                while (x < x1 && y <= draw_end[x])
+                    x++;
+                a = x;
+                while (x < x1 && y > draw_end[x])
+                    x++;
+                span_fill_h(&g->frame, y, a, x, rgb(60,120,60));
+            }
+            y++;
+        }
+        return ;
+    }
+    const int   tw = t->w;
+    const int   th = t->h;
+    const int   tbpp = t->bpp / 8;
+    while (y < h)
+    {
+        unsigned int    *row = g->frame.rows[y];
+        unsigned int    fx = fr->base_x[y] + (unsigned int)fr->step_x[y] * x0;
+        unsigned int    fy = fr->base_y[y] + (unsigned int)fr->step_y[y] * x0;
+        const int       sx = fr->step_x[y];
+        const int       sy = fr->step_y[y];
+        const int       s = fr->shade[y];
+
+        x = x0;
+        while (x < x1)
+        {
+            /* Colonne encore couverte par le mur: rien à faire */
+            if (y > draw_end[x])
+            {
+                /* Fraction 16 bits de la position monde -> texel de la tuile */
+                int tx = (int)(((fx & 0xFFFF) * (unsigned int)tw) >> 16);
+                int ty = (int)(((fy & 0xFFFF) * (unsigned int)th) >> 16);
+                row[x] = (unsigned int)shade_color(
+                    *(int *)(t->addr + ty * t->line_len + tx * tbpp), s);
+            }
+            fx += (unsigned int)sx;
+            fy += (unsigned int)sy;
+            x++;
+        }
+        y++;
+    }
+}
+
+/* ---------- 4) Mur texturé ----------
+   tex_x vient de wall_x (fraction 0..1); on parcourt ensuite verticalement
+   la bande avec span_copy_v. Une texture TEX_COL_MAJOR fournit sa colonne
+   tex_x en mémoire contiguë (un texel après l'autre); sinon chaque texel
+   est à line_len octets du précédent. En FB_TRANSPOSED la bande s'écrit
+   elle aussi de façon contiguë, dans g->colfb. */
+
+void    stage_walls(t_game *g, int x0, int x1)
+{
+    const int   h = g->view.h;
+    t_hits      *hs = &g->hits;
+    t_tex       *t = &g->tex_wall;
+    int         x;
+
+    x = x0;
+    while (x < x1)
+    {
+        int   line_h = hs->line_h[x];
+        int   draw_start = hs->draw_start[x];
+        int   draw_end = hs->draw_end[x];
+        /* Coordonnée horizontale dans la texture de mur (colonne) */
+        int   tex_x = (int)(hs->wall_x[x] * (float)t->w);
+        /* Inversion selon la face impactée (évite la texture "miroir") */
+        if ((hs->side[x] == 0 && hs->ray_dir_x[x] > 0)
+            || (hs->side[x] == 1 && hs->ray_dir_y[x] < 0))
+            tex_x = t->w - tex_x - 1;
+
+        /* step = pixels texture par pixel écran; tex_pos = départ aligné */
+        float step = (float)t->h / (float)line_h;
+        float tex_pos = (draw_start - h / 2 + line_h / 2) * step;
+
+        /* Colonne tex_x de la texture: contiguë si TEX_COL_MAJOR, sinon un
+           texel par ligne de texture */
+        t_span_src src;
+        if (t->layout == TEX_COL_MAJOR)
+        {
+            src.texels = t->px + tex_x * t->h;
+            src.stride = 1;
+        }
+        else
+        {
+            src.texels = (const unsigned int *)t->addr + tex_x;
+            src.stride = t->line_len / 4;
+        }
+        src.len = t->h;
+        src.pos = tex_pos;
+        src.step = step;
+        /* Destination: l'image, ou colfb (même table de lignes) en mode transposé */
+        span_copy_v(g->fb_mode == FB_TRANSPOSED ? &g->colfb : &g->frame,
+                    x, draw_start, draw_end + 1, &src);
+        x++;
+    }
+}
+
+/* ==========================================================================
+**  Orchestration
+**  --------------------------------------------------------------------------
+**  render_pass  : exécute UNE passe sur toutes les colonnes, en tuiles
+**                 réparties par le scheduler work-stealing
+**  view_update  : fige caméra + taille de l'écran pour la frame
+**  render_scene : enchaîne les passes (ordre selon le mode de framebuffer)
+**  render_frame : render_scene, surcouche du profileur, agrandissement si
+**                 la cible est réduite, mesure pour le gouverneur, puis
+**                 present du backend
+**  render_invalidate : signale un changement (bits DIRTY_*) à loop_hook
+** ========================================================================== */
+
+typedef struct s_pass
+{
+    t_game      *g;
+    t_stage_fn  fn;
+}   t_pass;
+
+static void pass_tile(void *arg, int x0, int x1, int worker)
+{
+    t_pass  *p = (t_pass *)arg;
+
+    (void)worker;
+    TRACE_BEGIN(p->g, worker, "tile", x0, x1);
+    PROF_TILE_BEGIN(p->g, worker);
+    p->fn(p->g, x0, x1);
+    PROF_TILE_END(p->g, worker);
+    TRACE_END(p->g, worker, "tile");
+}
+
+void    render_pass(t_game *g, t_stage_fn fn)
+{
+    t_pass  p;
+
+    p.g = g;
+    p.fn = fn;
+    /* sched_run ne rend la main qu'une fois toutes les tuiles faites:
+       la passe suivante peut donc lire les résultats de celle-ci */
+    sched_run(&g->sched, &g->pool, pass_tile, &p);
+}
+
+void    view_update(t_game *g)
+{
+    /* Instantané de la caméra: les workers ne lisent que g->view */
+    g->view.pos = g->p.pos;
+    g->view.dir = g->p.dir;
+    g->view.plane = g->p.plane;
+    g->view.sky_off = (g->tex_sky.w > 0) ? g->sky_off % g->tex_sky.w : 0;
+    g->view.w = g->frame.w;
+    g->view.h = g->frame.h;
+}
+
+void    render_scene(t_game *g)
+{
+    bool    transposed;
+
+    view_update(g);
+    PROF_BEGIN(g, PROF_DDA);
+    render_pass(g, stage_hits);
+    PROF_END(g, PROF_DDA);
+    /* Mode transposé: murs dans colfb puis transposition par blocs. Ciel et
+       sol passent APRÈS et recouvrent ce que la transposition a recopié
+       hors des bandes de mur. Repli en mode direct si l'allocation échoue. */
+    transposed = (g->fb_mode == FB_TRANSPOSED && colfb_ensure(g));
+    if (!transposed)
+        g->fb_mode = FB_DIRECT;
+    if (transposed)
+    {
+        PROF_BEGIN(g, PROF_WALLS);
+        render_pass(g, stage_walls);
+        PROF_END(g, PROF_WALLS);
+        PROF_BEGIN(g, PROF_TRANSPOSE);
+        render_pass(g, stage_transpose);
+        PROF_END(g, PROF_TRANSPOSE);
+    }
+    PROF_BEGIN(g, PROF_SKY);
+    sky_lut_update(g);
+    render_pass(g, stage_sky);
+    PROF_END(g, PROF_SKY);
+    PROF_BEGIN(g, PROF_FLOOR);
+    floor_rows_update(g);
+    render_pass(g, stage_floor);
+    PROF_END(g, PROF_FLOOR);
+    if (!transposed)
+    {
+        PROF_BEGIN(g, PROF_WALLS);
+        render_pass(g, stage_walls);
+        PROF_END(g, PROF_WALLS);
+    }
+    /* Sprites par-dessus tout le reste, masqués colonne par colonne par zbuf */
+    PROF_BEGIN(g, PROF_SPRITES);
+    sprites_project(g);
+    if (g->svis_count > 0)
+        render_pass(g, stage_sprites);
+    PROF_END(g, PROF_SPRITES);
+}
+
+void    render_frame(t_game *g)
+{
+    long long   t0;
+
+    /* Temps mesuré pour le gouverneur: rendu + agrandissement (hors affichage) */
+    t0 = clock_ns();
+    render_scene(g);
+    PROF_OVERLAY(g);
+    PROF_BEGIN(g, PROF_UPSCALE);
+    rt_upscale(g);
+    PROF_END(g, PROF_UPSCALE);
+    drs_update(g, clock_ns() - t0);
+
+    /* Affiche l'écran (fenêtre MLX, ou simple comptage sans affichage) */
+    PROF_BEGIN(g, PROF_PRESENT);
+    g->be->present(g);
+    PROF_END(g, PROF_PRESENT);
+    PROF_FRAME_END(g);
+}
+
+void    render_invalidate(t_game *g, unsigned int flags)
+{
+    g->dirty |= flags;
+}
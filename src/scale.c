@@ -0,0 +1,249 @@
+#include "game.h"
+#include <immintrin.h>  /* gather AVX2 (activé par fonction) */
+#include <stdio.h>      /* fprintf() pour le rapport du gouverneur */
+
+/* ==========================================================================
+**  Résolution dynamique (cible interne + gouverneur + agrandissement)
+**  --------------------------------------------------------------------------
+**  Sur une machine chargée, une frame pleine résolution peut dépasser son
+**  budget. Le rendu se fait donc dans g->frame, une cible interne dont la
+**  taille suit un palier de DRS_LEVELS; g->screen (image MLX) reçoit
+**  ensuite la cible agrandie au plus proche voisin. À 100 %, g->frame est
+**  un simple alias de g->screen: aucune copie.
+**
+**  drs_init     : lit POKE3D_FRAME_MS / POKE3D_DRS_STATS, choisit le noyau;
+**                 gouverneur éteint sans affichage, sauf POKE3D_FRAME_MS
+**  rt_resize    : (ré)alloue la cible w×h et tout ce qui dépend de sa taille
+**  rt_fit       : rt_resize au palier courant pour la taille de l'écran
+**  rt_free      : libère la cible et les tables d'agrandissement
+**  rt_upscale   : agrandit la cible dans l'écran (bandes de lignes en parallèle)
+**  drs_update   : mesure une frame et change de palier si besoin
+**  drs_stats    : palier courant, temps mesurés et décisions
+** ========================================================================== */
+
+static const int    g_drs_pct[] = DRS_LEVELS;
+
+/* ---------- Noyaux: une ligne écran depuis une ligne de la cible ---------- */
+
+static void up_scalar(const unsigned int *src, const int *xs,
+                      unsigned int *dst, int n)
+{
+    int x;
+
+    x = 0;
+    while (x < n)
+    {
+        dst[x] = src[xs[x]];
+        x++;
+    }
+}
+
+__attribute__((target("avx2")))
+static void up_avx2(const unsigned int *src, const int *xs,
+                    unsigned int *dst, int n)
+{
+    int x;
+
+    /* 8 pixels par gather: les indices sont déjà calculés dans xs */
+    x = 0;
+    while (x + 8 <= n)
+    {
+        __m256i idx = _mm256_loadu_si256((const __m256i *)(xs + x));
+        __m256i px = _mm256_i32gather_epi32((const int *)src, idx, 4);
+        _mm256_storeu_si256((__m256i *)(dst + x), px);
+        x += 8;
+    }
+    up_scalar(src, xs + x, dst + x, n - x);
+}
+
+void    drs_init(t_game *g)
+{
+    t_drs       *d = &g->drs;
+    const char  *env;
+
+    __builtin_memset(d, 0, sizeof(*d));
+    d->nlevels = (int)(sizeof(g_drs_pct) / sizeof(g_drs_pct[0]));
+    /* Sans affichage: pleine résolution fixe, sauf cible demandée */
+    d->last.target_ms = g->headless ? 0.0 : DRS_TARGET_MS;
+    env = getenv("POKE3D_FRAME_MS");
+    if (env && *env)
+        d->last.target_ms = strtod(env, NULL);
+    if (d->last.target_ms < 0.0) d->last.target_ms = 0.0;
+    env = getenv("POKE3D_DRS_STATS");
+    d->report = (env && *env && *env != '0');
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2"))
+        d->upscale = up_avx2, d->last.upscale = "avx2-gather";
+    else
+        d->upscale = up_scalar, d->last.upscale = "scalar";
+    d->last.pct = g_drs_pct[0];
+    d->cooldown = DRS_COOLDOWN;
+}
+
+void    rt_free(t_game *g)
+{
+    t_drs   *d = &g->drs;
+
+    img_rows_free(&g->frame);
+    free(d->rt_buf);
+    free(d->xs);
+    free(d->ys);
+    d->rt_buf = NULL;
+    d->xs = NULL;
+    d->ys = NULL;
+    __builtin_memset(&g->frame, 0, sizeof(g->frame));
+}
+
+/* La cible partage le format de l'écran (32 bits); seules la taille et
+   l'adresse changent. Les tables du rendu (impacts, lignes de sol, ciel)
+   et le scheduler dépendent de la largeur/hauteur: on les refait ici. */
+int     rt_resize(t_game *g, int w, int h)
+{
+    t_drs   *d = &g->drs;
+    int     i;
+
+    if (w < 1) w = 1;
+    if (h < 1) h = 1;
+    rt_free(g);
+    g->frame.w = w;
+    g->frame.h = h;
+    g->frame.bpp = 32;
+    g->frame.endian = g->screen.endian;
+    if (w == g->screen.w && h == g->screen.h)
+    {
+        g->frame.addr = g->screen.addr;
+        g->frame.line_len = g->screen.line_len;
+    }
+    else
+    {
+        if (posix_memalign((void **)&d->rt_buf, 64, sizeof(unsigned int) * w * h))
+        {
+            d->rt_buf = NULL;
+            return (0);
+        }
+        g->frame.addr = d->rt_buf;
+        g->frame.line_len = w * 4;
+        d->xs = (int *)malloc(sizeof(int) * g->screen.w);
+        d->ys = (int *)malloc(sizeof(int) * g->screen.h);
+        if (!d->xs || !d->ys)
+            return (0);
+        i = 0;
+        while (i < g->screen.w)
+        {
+            d->xs[i] = (int)((long long)i * w / g->screen.w);
+            i++;
+        }
+        i = 0;
+        while (i < g->screen.h)
+        {
+            d->ys[i] = (int)((long long)i * h / g->screen.h);
+            i++;
+        }
+    }
+    if (!img_rows_build(&g->frame, (unsigned int *)g->frame.addr,
+                        1, g->frame.line_len / 4))
+        return (0);
+    d->last.rt_w = w;
+    d->last.rt_h = h;
+    sched_destroy(&g->sched);
+    if (!sched_init(&g->sched, g->pool.count, w, sched_tile_width()))
+        return (0);
+    return (render_alloc(g, w, h));
+}
+
+int     rt_fit(t_game *g)
+{
+    const int   pct = g_drs_pct[g->drs.level];
+
+    return (rt_resize(g, g->screen.w * pct / 100, g->screen.h * pct / 100));
+}
+
+/* Chaque worker agrandit une bande contiguë de lignes écran. Les lignes
+   écran qui lisent la même ligne source que la précédente sont recopiées
+   telles quelles (memcpy) au lieu d'être ré-échantillonnées. */
+static void upscale_job(void *arg, int worker, int nworkers)
+{
+    t_game          *g = (t_game *)arg;
+    const t_drs     *d = &g->drs;
+    const int       sw = g->screen.w;
+    const int       sh = g->screen.h;
+    int             y;
+    int             y1;
+
+    y = sh * worker / nworkers;
+    y1 = sh * (worker + 1) / nworkers;
+    PROF_TILE_BEGIN(g, worker);
+    while (y < y1)
+    {
+        if (y > sh * worker / nworkers && d->ys[y] == d->ys[y - 1])
+            __builtin_memcpy(g->screen.rows[y], g->screen.rows[y - 1],
+                             sizeof(unsigned int) * sw);
+        else
+            d->upscale(g->frame.rows[d->ys[y]], d->xs, g->screen.rows[y], sw);
+        y++;
+    }
+    PROF_TILE_END(g, worker);
+}
+
+void    rt_upscale(t_game *g)
+{
+    if (!g->drs.rt_buf)
+        return ;
+    pool_run(&g->pool, upscale_job, g);
+}
+
+static void drs_set_level(t_game *g, int level, int decision)
+{
+    t_drs   *d = &g->drs;
+    int     pct = g_drs_pct[level];
+
+    d->level = level;
+    d->last.level = level;
+    d->last.pct = pct;
+    d->last.decision = decision;
+    if (decision == DRS_LOWER) d->last.lowered++;
+    if (decision == DRS_RAISE) d->last.raised++;
+    if (!rt_resize(g, g->screen.w * pct / 100, g->screen.h * pct / 100))
+    {
+        /* Repli pleine résolution (alias de l'écran, pas de tampon) */
+        d->level = 0;
+        d->last.level = 0;
+        d->last.pct = g_drs_pct[0];
+        if (!rt_resize(g, g->screen.w, g->screen.h))
+            panic("rt_resize failed");
+    }
+    if (d->report)
+        fprintf(stderr, "drs: %s -> %d%% (%dx%d), smoothed %.2f ms, target %.2f ms\n",
+                decision == DRS_LOWER ? "lower" : "raise", g_drs_pct[d->level],
+                g->frame.w, g->frame.h, d->ema_ms, d->last.target_ms);
+    /* La moyenne reflétait l'ancien palier: on repart de la prochaine mesure */
+    d->ema_ms = 0.0;
+    d->last.ema_ms = 0.0;
+    d->cooldown = DRS_COOLDOWN;
+}
+
+void    drs_update(t_game *g, long long frame_ns)
+{
+    t_drs           *d = &g->drs;
+    const double    target = d->last.target_ms;
+    double          ms = frame_ns / 1e6;
+
+    d->last.last_ms = ms;
+    d->ema_ms = (d->ema_ms == 0.0) ? ms : d->ema_ms * 0.9 + ms * 0.1;
+    d->last.ema_ms = d->ema_ms;
+    d->last.decision = DRS_HOLD;
+    if (d->cooldown > 0)
+        d->cooldown--;
+    if (target <= 0.0 || d->cooldown > 0)
+        return ;
+    /* Hystérésis: deux seuils distincts pour ne pas osciller entre paliers */
+    if (d->ema_ms > target * DRS_DOWN && d->level < d->nlevels - 1)
+        drs_set_level(g, d->level + 1, DRS_LOWER);
+    else if (d->ema_ms < target * DRS_UP && d->level > 0)
+        drs_set_level(g, d->level - 1, DRS_RAISE);
+}
+
+const t_drs_stats   *drs_stats(const t_game *g)
+{
+    return (&g->drs.last);
+}
@@ -0,0 +1,238 @@
+#include "game.h"
+#include <stdio.h>    /* fprintf() pour le rapport de stats */
+
+/* ==========================================================================
+**  Scheduler work-stealing par tuiles de colonnes
+**  --------------------------------------------------------------------------
+**  Le coût d'une colonne varie beaucoup (long couloir = beaucoup de pas DDA,
+**  beaucoup de sol = floor casting coûteux). Un découpage fixe laisse des
+**  cœurs inactifs: ici chaque worker possède un deque de petites tuiles,
+**  commence par les siennes (contiguës, bonne localité) puis vole celles
+**  des autres quand il n'a plus rien.
+**
+**  sched_tile_width : largeur de tuile (TILE_COLS ou POKE3D_TILE)
+**  sched_init       : alloue deques + compteurs pour nworkers workers
+**  sched_run        : répartit les tuiles et exécute fn sur le pool
+**  sched_stats      : stats de déséquilibre de la dernière passe
+**  sched_destroy    : libère tout
+** ========================================================================== */
+
+#define SPAN(top, bot)  (((unsigned long long)(top) << 32) | (unsigned)(bot))
+#define SPAN_TOP(v)     ((int)((v) >> 32))
+#define SPAN_BOT(v)     ((int)((v) & 0xFFFFFFFFu))
+
+int     sched_tile_width(void)
+{
+    const char  *env;
+    long        n;
+
+    n = TILE_COLS;
+    env = getenv("POKE3D_TILE");
+    if (env && *env)
+        n = strtol(env, NULL, 10);
+    if (n < 1) n = 1;
+    return ((int)n);
+}
+
+int     sched_init(t_sched *s, int nworkers, int width, int tile_w)
+{
+    const char  *env;
+    int         i;
+
+    __builtin_memset(s, 0, sizeof(*s));
+    s->nworkers = nworkers;
+    s->width = width;
+    s->tile_w = (tile_w < 1) ? 1 : tile_w;
+    s->ntiles = (width + s->tile_w - 1) / s->tile_w;
+    /* Alignement 64 octets: chaque deque/compteur sur sa propre ligne de cache */
+    if (posix_memalign((void **)&s->deques, 64, sizeof(t_deque) * nworkers)
+        || posix_memalign((void **)&s->ws, 64, sizeof(t_wstats) * nworkers))
+        return (0);
+    __builtin_memset(s->deques, 0, sizeof(t_deque) * nworkers);
+    __builtin_memset(s->ws, 0, sizeof(t_wstats) * nworkers);
+    i = 0;
+    while (i < nworkers)
+    {
+        /* Capacité = toutes les tuiles (cas d'un seul worker) */
+        s->deques[i].tiles = (int *)malloc(sizeof(int) * (s->ntiles + 1));
+        if (!s->deques[i].tiles)
+            return (0);
+        i++;
+    }
+    env = getenv("POKE3D_SCHED_STATS");
+    s->report = (env && *env && *env != '0');
+    return (1);
+}
+
+/* Propriétaire: prend la tuile du bas. Renvoie -1 si le deque est vide. */
+static int  deque_pop(t_deque *d)
+{
+    unsigned long long  v;
+    int                 top;
+    int                 bot;
+
+    v = atomic_load_explicit(&d->span, memory_order_acquire);
+    while (1)
+    {
+        top = SPAN_TOP(v);
+        bot = SPAN_BOT(v);
+        if (top >= bot)
+            return (-1);
+        if (atomic_compare_exchange_weak_explicit(&d->span, &v,
+                SPAN(top, bot - 1), memory_order_acq_rel, memory_order_acquire))
+            return (d->tiles[bot - 1]);
+    }
+}
+
+/* Voleur: prend la tuile du haut (la plus éloignée du travail du propriétaire). */
+static int  deque_steal(t_deque *d)
+{
+    unsigned long long  v;
+    int                 top;
+    int                 bot;
+
+    v = atomic_load_explicit(&d->span, memory_order_acquire);
+    while (1)
+    {
+        top = SPAN_TOP(v);
+        bot = SPAN_BOT(v);
+        if (top >= bot)
+            return (-1);
+        if (atomic_compare_exchange_weak_explicit(&d->span, &v,
+                SPAN(top + 1, bot), memory_order_acq_rel, memory_order_acquire))
+            return (d->tiles[top]);
+    }
+}
+
+static void run_tile(t_sched *s, int tile, int worker)
+{
+    int x0 = tile * s->tile_w;
+    int x1 = x0 + s->tile_w;
+
+    if (x1 > s->width) x1 = s->width;
+    s->fn(s->arg, x0, x1, worker);
+}
+
+static void sched_job(void *arg, int worker, int nworkers)
+{
+    t_sched     *s = (t_sched *)arg;
+    t_wstats    *ws = &s->ws[worker];
+    long long   t0;
+    int         tile;
+    int         k;
+
+    /* 1) Ses propres tuiles d'abord */
+    while ((tile = deque_pop(&s->deques[worker])) >= 0)
+    {
+        t0 = clock_ns();
+        run_tile(s, tile, worker);
+        ws->busy_ns += clock_ns() - t0;
+        ws->tiles++;
+    }
+    /* 2) Puis vol: on balaie les autres workers jusqu'à ce que tout soit vide */
+    k = 1;
+    while (k < nworkers)
+    {
+        tile = deque_steal(&s->deques[(worker + k) % nworkers]);
+        if (tile < 0)
+        {
+            k++;
+            continue ;
+        }
+        t0 = clock_ns();
+        run_tile(s, tile, worker);
+        ws->busy_ns += clock_ns() - t0;
+        ws->tiles++;
+        ws->steals++;
+        k = 1; /* la victime a peut-être encore du travail: on recommence */
+    }
+}
+
+static void sched_collect(t_sched *s, long long wall_ns)
+{
+    t_sched_stats   *st = &s->last;
+    long long       sum = 0;
+    long long       mx = 0;
+    int             i;
+
+    __builtin_memset(st, 0, sizeof(*st));
+    i = 0;
+    while (i < s->nworkers)
+    {
+        sum += s->ws[i].busy_ns;
+        if (s->ws[i].busy_ns > mx) mx = s->ws[i].busy_ns;
+        st->steals += s->ws[i].steals;
+        st->tiles += s->ws[i].tiles;
+        i++;
+    }
+    st->frame_ms = wall_ns / 1e6;
+    st->mean_busy_ms = (sum / (double)s->nworkers) / 1e6;
+    st->max_busy_ms = mx / 1e6;
+    st->imbalance = (sum > 0) ? (mx * (double)s->nworkers) / (double)sum : 1.0;
+    st->tile_w = s->tile_w;
+
+    /* Rapport agrégé toutes les SCHED_REPORT_EVERY passes */
+    s->frames++;
+    s->acc_imbalance += st->imbalance;
+    if (st->imbalance > s->max_imbalance) s->max_imbalance = st->imbalance;
+    if (s->report && s->frames % SCHED_REPORT_EVERY == 0)
+    {
+        fprintf(stderr, "sched: tile=%d workers=%d imbalance avg=%.3f max=%.3f"
+                " last: %.2f ms (busy mean %.2f / max %.2f) steals=%d\n",
+                s->tile_w, s->nworkers, s->acc_imbalance / SCHED_REPORT_EVERY,
+                s->max_imbalance, st->frame_ms, st->mean_busy_ms,
+                st->max_busy_ms, st->steals);
+        s->acc_imbalance = 0.0;
+        s->max_imbalance = 0.0;
+    }
+}
+
+void    sched_run(t_sched *s, t_pool *pool, t_tile_fn fn, void *arg)
+{
+    long long   t0;
+    int         w;
+    int         a;
+    int         b;
+    int         i;
+
+    s->fn = fn;
+    s->arg = arg;
+    /* Distribution initiale: un bloc contigu de tuiles par worker, stocké
+       à l'envers pour que le propriétaire les dépile dans l'ordre croissant */
+    w = 0;
+    while (w < s->nworkers)
+    {
+        a = s->ntiles * w / s->nworkers;
+        b = s->ntiles * (w + 1) / s->nworkers;
+        i = 0;
+        while (a + i < b)
+        {
+            s->deques[w].tiles[i] = b - 1 - i;
+            i++;
+        }
+        atomic_store_explicit(&s->deques[w].span, SPAN(0, i), memory_order_release);
+        __builtin_memset(&s->ws[w], 0, sizeof(t_wstats));
+        w++;
+    }
+    t0 = clock_ns();
+    pool_run(pool, sched_job, s);
+    sched_collect(s, clock_ns() - t0);
+}
+
+const t_sched_stats *sched_stats(const t_sched *s)
+{
+    return (&s->last);
+}
+
+void    sched_destroy(t_sched *s)
+{
+    int i;
+
+    i = 0;
+    while (s->deques && i < s->nworkers)
+        free(s->deques[i++].tiles);
+    free(s->deques);
+    free(s->ws);
+    s->deques = NULL;
+    s->ws = NULL;
+}
@@ -0,0 +1,105 @@
+#include "game.h"
+
+/* ==========================================================================
+**  Spans — écriture du framebuffer par segments
+**  --------------------------------------------------------------------------
+**  put_pixel borne x et y, multiplie par line_len et divise bpp par 8 à
+**  CHAQUE pixel. Les passes de rendu écrivent par segments: on borne une
+**  fois par segment, puis on écrit via une table de pointeurs de lignes.
+**  La table décrit aussi le buffer column-major du mode transposé
+**  (xstep = hauteur de colonne, ystep = 1): mêmes fonctions pour les deux.
+**
+**  img_rows_build : construit rows[y] = base + y * ystep pour une image w×h
+**  img_rows_free  : libère la table
+**  span_copy_v    : copie une colonne de texture (t_span_src) dans [y0, y1)
+**  span_fill_h    : remplit la ligne y, colonnes [x0, x1), d'une couleur
+** ========================================================================== */
+
+int     img_rows_build(t_img *img, unsigned int *base, int xstep, int ystep)
+{
+    int y;
+
+    img_rows_free(img);
+    if (img->h <= 0)
+        return (0);
+    img->rows = (unsigned int **)malloc(sizeof(unsigned int *) * img->h);
+    if (!img->rows)
+        return (0);
+    y = 0;
+    while (y < img->h)
+    {
+        img->rows[y] = base + (size_t)y * ystep;
+        y++;
+    }
+    img->xstep = xstep;
+    img->ystep = ystep;
+    return (1);
+}
+
+void    img_rows_free(t_img *img)
+{
+    free(img->rows);
+    img->rows = NULL;
+}
+
+/* Borne [y0, y1) à la hauteur de l'image; renvoie 0 si la span est vide */
+static inline int   clip_v(const t_img *img, int x, int *y0, int *y1)
+{
+    if (x < 0 || x >= img->w)
+        return (0);
+    if (*y0 < 0) *y0 = 0;
+    if (*y1 > img->h) *y1 = img->h;
+    return (*y0 < *y1);
+}
+
+void    span_copy_v(t_img *img, int x, int y0, int y1, const t_span_src *src)
+{
+    const unsigned int  *tex = src->texels;
+    const int           ts = src->stride;
+    const int           last = src->len - 1;
+    unsigned int        *p;
+    float               pos;
+    int                 ys;
+    int                 n;
+    int                 ty;
+
+    pos = src->pos;
+    if (y0 < 0)
+        pos += (float)(-y0) * src->step; /* lignes coupées en haut */
+    if (!clip_v(img, x, &y0, &y1))
+        return ;
+    p = img->rows[y0] + (size_t)x * img->xstep;
+    ys = img->ystep;
+    n = y1 - y0;
+    while (n-- > 0)
+    {
+        ty = (int)pos;
+        if (ty < 0) ty = 0;
+        if (ty > last) ty = last;
+        pos += src->step;
+        *p = tex[ty * ts];
+        p += ys;
+    }
+}
+
+void    span_fill_h(t_img *img, int y, int x0, int x1, int color)
+{
+    unsigned int    *p;
+    int             xs;
+    int             n;
+
+    if (y < 0 || y >= img->h)
+        return ;
+    if (x0 < 0) x0 = 0;
+    if (x1 > img->w) x1 = img->w;
+    if (x0 >= x1)
+        return ;
+    p = img->rows[y] + (size_t)x0 * img->xstep;
+    xs = img->xstep;
+    n = x1 - x0;
+    while (n-- > 0)
+    {
+        *p = (unsigned int)color;
+        p += xs;
+    }
+}
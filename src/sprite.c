@@ -0,0 +1,394 @@
+#include "game.h"
+
+/* ==========================================================================
+**  Sprites — Pokéballs à ramasser (billboards)
+**  --------------------------------------------------------------------------
+**  Chaque case 'C' de la carte porte une Pokéball (case vide pour la DDA).
+**  Par frame, après la passe des impacts (zbuf = perp_dist par colonne):
+**    1) sprites_project (thread principal): les sprites des cases dans le
+**       champ (sgrid_query_wedge, sprite_grid.c) passent en espace
+**       caméra, rejet derrière la caméra / hors écran, tri du plus loin au
+**       plus proche dans g->svis
+**    2) stage_sprites (tuiles en parallèle): chaque sprite visible est
+**       dessiné colonne par colonne; une colonne entière est rejetée d'un
+**       coup si le mur de cette colonne est plus proche (zbuf). Seuls les
+**       segments opaques de la colonne de texture (pokeball_runs, calculés
+**       au chargement) sont copiés: les texels transparents (clé
+**       0xFF000000, "None" en XPM) ne sont ni lus ni testés.
+**  Un sprite hors champ ne coûte rien (sa case n'est pas visitée); un
+**  sprite caché par un mur, un test par colonne. Le ramassage ne regarde
+**  que les cases voisines du joueur.
+**
+**  sprites_load    : construit le tableau global sprites (et leur index
+**                    par case) depuis les lignes de la carte
+**  sprites_reserve : remplace les sprites par un tableau vide de n places
+**                    (le chargeur remplit sprites[sprite_count++] puis
+**                    construit l'index par sgrid_build)
+**  sprites_free    : libère sprites, l'index et la liste des visibles
+**  sprites_project : liste triée des sprites visibles de la frame
+**  sprite_pickup   : ramasse les Pokéballs au contact du joueur
+**  stage_sprites   : passe de rendu des billboards
+**  tex_sprite_procedural : Pokéball dessinée en mémoire (asset absent)
+**  sprite_runs_build : segments opaques par colonne d'une texture de sprite
+**  sprite_runs_free  : libère les segments
+** ========================================================================== */
+
+void    sprites_reserve(t_game *g, int n)
+{
+    sprites_free(g);
+    if (n == 0)
+        return ;
+    sprites = (t_sprite *)malloc(sizeof(t_sprite) * n);
+    g->svis = (t_sprite_vis *)malloc(sizeof(t_sprite_vis) * n);
+    if (!sprites || !g->svis)
+        panic("malloc sprites");
+}
+
+void    sprites_load(t_game *g, const char *const *rows)
+{
+    int x;
+    int y;
+    int n;
+
+    n = 0;
+    y = 0;
+    while (rows[y])
+    {
+        x = 0;
+        while (rows[y][x])
+            n += (rows[y][x++] == 'C');
+        y++;
+    }
+    sprites_reserve(g, n);
+    if (n == 0)
+        return ;
+    y = 0;
+    while (rows[y])
+    {
+        x = 0;
+        while (rows[y][x])
+        {
+            if (rows[y][x] == 'C')
+            {
+                sprites[sprite_count].x = x + 0.5f;
+                sprites[sprite_count].y = y + 0.5f;
+                sprites[sprite_count].active = true;
+                sprite_count++;
+            }
+            x++;
+        }
+        y++;
+    }
+    if (!sgrid_build(g))
+        panic("malloc sprite grid");
+}
+
+void    sprites_free(t_game *g)
+{
+    sgrid_free(g);
+    free(sprites);
+    free(g->svis);
+    sprites = NULL;
+    g->svis = NULL;
+    sprite_count = 0;
+    g->svis_count = 0;
+    collected = 0;
+}
+
+static int  cmp_far_first(const void *a, const void *b)
+{
+    float   da = ((const t_sprite_vis *)a)->depth;
+    float   db = ((const t_sprite_vis *)b)->depth;
+
+    return ((da < db) - (da > db));
+}
+
+void    sprites_project(t_game *g)
+{
+    const t_view    *v = &g->view;
+    /* Inverse de la matrice caméra [plane dir] */
+    const float     inv_det = 1.0f / (v->plane.x * v->dir.y - v->dir.x * v->plane.y);
+    const t_sprite  *sp;
+    t_sprite_vis    *s;
+    float           sx;
+    float           sy;
+    float           tx;
+    float           ty;
+    int             n;
+    int             i;
+
+    g->svis_count = 0;
+    if (!tex_pokeball.px)
+        return ;
+    n = sgrid_query_wedge(g, v);
+    i = 0;
+    while (i < n)
+    {
+        sp = &sprites[g->sgrid.found[i++]];
+        sx = sp->x - v->pos.x;
+        sy = sp->y - v->pos.y;
+        tx = inv_det * (v->dir.y * sx - v->dir.x * sy);
+        ty = inv_det * (-v->plane.y * sx + v->plane.x * sy);
+        if (ty < SPRITE_NEAR)
+            continue ;      /* derrière (ou contre) la caméra */
+        s = &g->svis[g->svis_count];
+        s->depth = ty;
+        s->size = (int)(v->h / ty * SPRITE_SCALE);
+        s->left = (int)(v->w * 0.5f * (1.0f + tx / ty)) - s->size / 2;
+        s->x0 = (s->left < 0) ? 0 : s->left;
+        s->x1 = (s->left + s->size > v->w) ? v->w : s->left + s->size;
+        if (s->size < 1 || s->x0 >= s->x1)
+            continue ;      /* hors champ */
+        /* Pied du billboard sur la ligne de sol d'un mur à cette distance */
+        s->y1 = v->h / 2 + (int)(v->h / ty) / 2;
+        s->y0 = s->y1 - s->size;
+        g->svis_count++;
+    }
+    /* Carte sans Pokéball (monde en chunks): svis n'est pas alloué */
+    if (g->svis_count > 1)
+        qsort(g->svis, g->svis_count, sizeof(t_sprite_vis), cmp_far_first);
+}
+
+void    sprite_pickup(t_game *g)
+{
+    float   dx;
+    float   dy;
+    int     id;
+    int     n;
+    int     i;
+
+    n = sgrid_query_near(g, g->p.pos);
+    i = 0;
+    while (i < n)
+    {
+        id = g->sgrid.found[i++];
+        dx = sprites[id].x - g->p.pos.x;
+        dy = sprites[id].y - g->p.pos.y;
+        if (dx * dx + dy * dy < SPRITE_PICKUP_R * SPRITE_PICKUP_R)
+        {
+            sprites[id].active = false;
+            sgrid_remove(g, id);
+            collected++;
+            render_invalidate(g, DIRTY_MAP);
+        }
+    }
+}
+
+/* Les deux blitters placent les texels de la même façon, en virgule fixe
+   16.16 (exacte, donc identique quel que soit le point de départ): la
+   ligne y0 + k du billboard lit le texel (k * step) >> 16. */
+static inline unsigned int  sprite_step(int th, int size)
+{
+    return ((unsigned int)(((unsigned long long)th << 16) / (unsigned int)size));
+}
+
+/* Référence (SPRITE_KEYED, ou segments absents): test de la clé sur
+   chaque texel de la colonne */
+static void sprite_column_keyed(t_img *img, int x, const t_sprite_vis *s,
+                                const unsigned int *col, int th)
+{
+    const unsigned int  step = sprite_step(th, s->size);
+    unsigned int        *p;
+    unsigned int        c;
+    unsigned int        pos;
+    int                 ty;
+    int                 y0;
+    int                 y1;
+
+    y0 = (s->y0 < 0) ? 0 : s->y0;
+    y1 = (s->y1 > img->h) ? img->h : s->y1;
+    if (y0 >= y1)
+        return ;
+    pos = (unsigned int)(y0 - s->y0) * step;
+    p = img->rows[y0] + (size_t)x * img->xstep;
+    while (y0 < y1)
+    {
+        ty = (int)(pos >> 16);
+        c = col[ty < th ? ty : th - 1];
+        if (!(c >> 24))
+            *p = c;
+        p += img->ystep;
+        pos += step;
+        y0++;
+    }
+}
+
+/* Segments opaques [r0, r1) de la colonne c: ils couvrent les lignes
+   k >= ceil((r0 << 16) / step) du billboard jusqu'à celle de r1 exclue.
+   Aucun test par texel: copie mise à l'échelle, segment par segment. */
+static void sprite_column_runs(t_img *img, int x, const t_sprite_vis *s,
+                               const unsigned int *col, int c)
+{
+    const t_sprite_runs *r = &pokeball_runs;
+    const unsigned int  step = sprite_step(r->h, s->size);
+    const int           ylim = (s->y1 > img->h) ? img->h : s->y1;
+    unsigned int        *p;
+    unsigned int        pos;
+    int                 k;
+    int                 a;
+    int                 b;
+
+    k = r->first[c];
+    while (k < r->first[c + 1])
+    {
+        a = s->y0 + (int)((((unsigned int)r->run[2 * k] << 16) + step - 1) / step);
+        b = s->y0 + (int)((((unsigned int)r->run[2 * k + 1] << 16) + step - 1) / step);
+        k++;
+        if (a < 0) a = 0;
+        if (b > ylim) b = ylim;
+        if (a >= b)
+            continue ;
+        pos = (unsigned int)(a - s->y0) * step;
+        p = img->rows[a] + (size_t)x * img->xstep;
+        while (a++ < b)
+        {
+            *p = col[pos >> 16];
+            p += img->ystep;
+            pos += step;
+        }
+    }
+}
+
+void    stage_sprites(t_game *g, int x0, int x1)
+{
+    const t_tex         *t = &tex_pokeball;
+    const float         *z = g->hits.perp_dist;
+    const bool          runs = (g->sprite_mode == SPRITE_RUNS && pokeball_runs.first);
+    const t_sprite_vis  *s;
+    int                 i;
+    int                 a;
+    int                 b;
+    int                 c;
+
+    i = 0;
+    while (i < g->svis_count)
+    {
+        s = &g->svis[i++];
+        a = (s->x0 > x0) ? s->x0 : x0;
+        b = (s->x1 < x1) ? s->x1 : x1;
+        while (a < b)
+        {
+            /* Mur plus proche sur cette colonne: colonne entière rejetée */
+            if (s->depth < z[a])
+            {
+                c = (a - s->left) * t->w / s->size;
+                if (runs)
+                    sprite_column_runs(&g->frame, a, s, t->px + (size_t)c * t->h, c);
+                else
+                    sprite_column_keyed(&g->frame, a, s, t->px + (size_t)c * t->h, t->h);
+            }
+            a++;
+        }
+    }
+}
+
+/* Pokéball de secours: haut rouge, bas blanc, bande et bouton noirs,
+   transparente hors du disque. Disposition TEX_COL_MAJOR (comme l'asset). */
+int     tex_sprite_procedural(t_tex *t, int size)
+{
+    const float c = (size - 1) * 0.5f;
+    float       dx;
+    float       dy;
+    float       d2;
+    unsigned int px;
+    int         x;
+    int         y;
+
+    t->img = NULL;
+    t->w = size;
+    t->h = size;
+    t->bpp = 32;
+    t->line_len = size * 4;
+    t->layout = TEX_COL_MAJOR;
+    t->addr = (char *)malloc((size_t)size * size * 4);
+    if (!t->addr)
+        return (0);
+    y = 0;
+    while (y < size)
+    {
+        x = 0;
+        while (x < size)
+        {
+            dx = (x - c) / c;
+            dy = (y - c) / c;
+            d2 = dx * dx + dy * dy;
+            if (d2 > 1.0f)
+                px = 0xFF000000u;
+            else if (d2 < 0.06f)
+                px = (d2 < 0.03f) ? 0xF0F0F0 : 0x101010;
+            else if (d2 > 0.85f || (dy > -0.08f && dy < 0.08f))
+                px = 0x101010;
+            else
+                px = (dy < 0.0f) ? 0xD02020 : 0xF0F0F0;
+            ((unsigned int *)t->addr)[y * size + x] = px;
+            x++;
+        }
+        y++;
+    }
+    return (tex_apply_layout(t));
+}
+
+/* Deux parcours de la texture (column-major): compte, puis remplit */
+static int  runs_scan(t_sprite_runs *r, const t_tex *t)
+{
+    const unsigned int  *col;
+    int                 n;
+    int                 c;
+    int                 y;
+
+    n = 0;
+    c = 0;
+    while (c < t->w)
+    {
+        if (r->first)
+            r->first[c] = n;
+        col = t->px + (size_t)c * t->h;
+        y = 0;
+        while (y < t->h)
+        {
+            while (y < t->h && (col[y] >> 24))
+                y++;
+            if (y == t->h)
+                break ;
+            if (r->run)
+                r->run[2 * n] = y;
+            while (y < t->h && !(col[y] >> 24))
+                y++;
+            if (r->run)
+                r->run[2 * n + 1] = y;
+            n++;
+        }
+        c++;
+    }
+    if (r->first)
+        r->first[t->w] = n;
+    return (n);
+}
+
+int     sprite_runs_build(t_sprite_runs *r, const t_tex *t)
+{
+    int n;
+
+    sprite_runs_free(r);
+    if (!t->px || t->layout != TEX_COL_MAJOR)
+        return (0);
+    n = runs_scan(r, t);
+    r->first = (int *)malloc(sizeof(int) * (t->w + 1));
+    r->run = (int *)malloc(sizeof(int) * 2 * (n > 0 ? n : 1));
+    if (!r->first || !r->run)
+    {
+        sprite_runs_free(r);
+        return (0);
+    }
+    runs_scan(r, t);
+    r->w = t->w;
+    r->h = t->h;
+    return (1);
+}
+
+void    sprite_runs_free(t_sprite_runs *r)
+{
+    free(r->first);
+    free(r->run);
+    __builtin_memset(r, 0, sizeof(*r));
+}
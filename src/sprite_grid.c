@@ -0,0 +1,206 @@
+#include "game.h"
+
+/* ==========================================================================
+**  Index spatial des sprites (grille uniforme de seaux de cases)
+**  --------------------------------------------------------------------------
+**  La carte est découpée en seaux de SGRID_B × SGRID_B cases; chaque seau
+**  tient la liste des sprites actifs qu'il contient. Les maillons
+**  (next/prev) vivent dans t_sprite, la grille ne garde que la tête de
+**  chaque liste. Un sprite ramassé est décroché en O(1). Une requête
+**  parcourt les seaux qui touchent sa zone et ne garde que les sprites
+**  dont la case y tombe.
+**
+**  Deux requêtes remplissent g->sgrid.found et renvoient le nombre d'ids:
+**    - le coin de vue: triangle (pos, pos + D·(dir - plane),
+**      pos + D·(dir + plane)) où D est la profondeur au-delà de laquelle
+**      un billboard fait moins d'un pixel (ty > h · SPRITE_SCALE, rejeté
+**      par sprites_project), plus SGRID_MARGIN; bornée par la carte. Sur
+**      une grande carte, la requête ne dépend donc que de la hauteur de
+**      l'image, pas de la taille du monde. Le triangle est parcouru
+**      ligne de seaux par ligne de seaux. Pour chaque ligne, les trois
+**      arêtes sont coupées à la bande (élargie de SGRID_MARGIN) et
+**      donnent l'intervalle de colonnes à visiter. La marge couvre la
+**      demi-largeur d'un billboard: un sprite dont le centre est juste hors
+**      du coin mais qui déborde à l'écran est quand même renvoyé. La
+**      projection exacte reste faite par sprites_project.
+**    - le voisinage: les 3×3 cases autour d'un point (ramassage, rayon
+**      SPRITE_PICKUP_R < 1 case).
+**
+**  sgrid_build       : accroche tous les sprites actifs à leur seau
+**  sgrid_free        : libère la grille
+**  sgrid_remove      : décroche un sprite de son seau
+**  sgrid_query_wedge : sprites des cases dans le champ de la caméra
+**  sgrid_query_near  : sprites des cases voisines d'un point
+** ========================================================================== */
+
+#define SGRID_MARGIN 0.5f
+#define SGRID_B      (1 << SGRID_SHIFT)
+
+/* Seau de la case du sprite s */
+static inline int   sgrid_bucket(const t_sprite_grid *gr, const t_sprite *s)
+{
+    return (((int)s->y >> SGRID_SHIFT) * gr->w + ((int)s->x >> SGRID_SHIFT));
+}
+
+int     sgrid_build(t_game *g)
+{
+    t_sprite_grid   *gr = &g->sgrid;
+    int             c;
+    int             i;
+
+    sgrid_free(g);
+    gr->w = (g->map_w + SGRID_B - 1) >> SGRID_SHIFT;
+    gr->h = (g->map_h + SGRID_B - 1) >> SGRID_SHIFT;
+    gr->head = (int *)calloc((size_t)gr->w * gr->h, sizeof(int));
+    gr->found = (int *)malloc(sizeof(int) * (sprite_count > 0 ? sprite_count : 1));
+    if (!gr->head || !gr->found)
+    {
+        sgrid_free(g);
+        return (0);
+    }
+    /* Insertion en tête, dans l'ordre inverse: chaque liste garde l'ordre
+       croissant des ids */
+    i = sprite_count;
+    while (i-- > 0)
+    {
+        sprites[i].next = -1;
+        sprites[i].prev = -1;
+        if (!sprites[i].active)
+            continue ;
+        c = sgrid_bucket(gr, &sprites[i]);
+        sprites[i].next = gr->head[c] - 1;
+        if (gr->head[c] > 0)
+            sprites[gr->head[c] - 1].prev = i;
+        gr->head[c] = i + 1;
+    }
+    return (1);
+}
+
+void    sgrid_free(t_game *g)
+{
+    free(g->sgrid.head);
+    free(g->sgrid.found);
+    __builtin_memset(&g->sgrid, 0, sizeof(g->sgrid));
+}
+
+void    sgrid_remove(t_game *g, int id)
+{
+    t_sprite    *s = &sprites[id];
+
+    if (s->prev >= 0)
+        sprites[s->prev].next = s->next;
+    else if (g->sgrid.head)
+        g->sgrid.head[sgrid_bucket(&g->sgrid, s)] = s->next + 1;
+    if (s->next >= 0)
+        sprites[s->next].prev = s->prev;
+    s->next = -1;
+    s->prev = -1;
+}
+
+/* Ajoute les sprites des cases [x0, x1] × [y0, y1]: seaux qui touchent
+   le rectangle, puis test de la case de chaque sprite */
+static int  collect_rect(t_game *g, int x0, int x1, int y0, int y1, int n)
+{
+    const t_sprite_grid *gr = &g->sgrid;
+    int                 bx;
+    int                 by;
+    int                 id;
+
+    if (x0 < 0) x0 = 0;
+    if (y0 < 0) y0 = 0;
+    if (x1 > g->map_w - 1) x1 = g->map_w - 1;
+    if (y1 > g->map_h - 1) y1 = g->map_h - 1;
+    by = y0 >> SGRID_SHIFT;
+    while (x0 <= x1 && by <= y1 >> SGRID_SHIFT)
+    {
+        bx = x0 >> SGRID_SHIFT;
+        while (bx <= x1 >> SGRID_SHIFT)
+        {
+            id = gr->head[by * gr->w + bx++] - 1;
+            while (id >= 0)
+            {
+                if ((int)sprites[id].x >= x0 && (int)sprites[id].x <= x1
+                    && (int)sprites[id].y >= y0 && (int)sprites[id].y <= y1)
+                    g->sgrid.found[n++] = id;
+                id = sprites[id].next;
+            }
+        }
+        by++;
+    }
+    return (n);
+}
+
+/* Étend [*lo, *hi] aux abscisses du segment (a, b) coupé à la bande
+   ya <= y <= yb */
+static void clip_edge(t_v2f a, t_v2f b, float ya, float yb, float *lo, float *hi)
+{
+    float   t0;
+    float   t1;
+    float   x;
+
+    if ((a.y < ya && b.y < ya) || (a.y > yb && b.y > yb))
+        return ;
+    t0 = 0.0f;
+    t1 = 1.0f;
+    if (a.y != b.y)
+    {
+        t0 = (ya - a.y) / (b.y - a.y);
+        t1 = (yb - a.y) / (b.y - a.y);
+        if (t0 > t1) { x = t0; t0 = t1; t1 = x; }
+        if (t0 < 0.0f) t0 = 0.0f;
+        if (t1 > 1.0f) t1 = 1.0f;
+    }
+    x = a.x + (b.x - a.x) * t0;
+    if (x < *lo) *lo = x;
+    if (x > *hi) *hi = x;
+    x = a.x + (b.x - a.x) * t1;
+    if (x < *lo) *lo = x;
+    if (x > *hi) *hi = x;
+}
+
+int     sgrid_query_wedge(t_game *g, const t_view *v)
+{
+    /* Au-delà, size = h / ty · SPRITE_SCALE < 1 pixel */
+    const float d = fminf(v->h * SPRITE_SCALE + SGRID_MARGIN,
+                          (float)(g->map_w + g->map_h + 2));
+    t_v2f       p[3];
+    float       lo;
+    float       hi;
+    int         y;
+    int         y1;
+    int         n;
+
+    if (!g->sgrid.head)
+        return (0);
+    p[0] = v->pos;
+    p[1].x = v->pos.x + d * (v->dir.x - v->plane.x);
+    p[1].y = v->pos.y + d * (v->dir.y - v->plane.y);
+    p[2].x = v->pos.x + d * (v->dir.x + v->plane.x);
+    p[2].y = v->pos.y + d * (v->dir.y + v->plane.y);
+    lo = fminf(p[0].y, fminf(p[1].y, p[2].y)) - SGRID_MARGIN;
+    hi = fmaxf(p[0].y, fmaxf(p[1].y, p[2].y)) + SGRID_MARGIN;
+    /* y, y1: premières cases de la première et de la dernière ligne de seaux */
+    y = (lo < 0.0f) ? 0 : ((int)lo & ~(SGRID_B - 1));
+    y1 = (hi > g->map_h - 1) ? g->map_h - 1 : (int)hi;
+    n = 0;
+    while (y <= y1)
+    {
+        lo = 1e30f;
+        hi = -1e30f;
+        clip_edge(p[0], p[1], y - SGRID_MARGIN, y + SGRID_B + SGRID_MARGIN, &lo, &hi);
+        clip_edge(p[1], p[2], y - SGRID_MARGIN, y + SGRID_B + SGRID_MARGIN, &lo, &hi);
+        clip_edge(p[2], p[0], y - SGRID_MARGIN, y + SGRID_B + SGRID_MARGIN, &lo, &hi);
+        if (lo <= hi)
+            n = collect_rect(g, (int)floorf(lo - SGRID_MARGIN),
+                             (int)floorf(hi + SGRID_MARGIN), y, y + SGRID_B - 1, n);
+        y += SGRID_B;
+    }
+    return (n);
+}
+
+int     sgrid_query_near(t_game *g, t_v2f p)
+{
+    if (!g->sgrid.head)
+        return (0);
+    return (collect_rect(g, (int)p.x - 1, (int)p.x + 1, (int)p.y - 1, (int)p.y + 1, 0));
+}
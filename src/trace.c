@@ -0,0 +1,253 @@
+#include "game.h"
+#include <stdio.h>    /* fopen(), fprintf() */
+
+/* ==========================================================================
+**  Trace d'événements (format Chrome / Perfetto "Trace Event")
+**  --------------------------------------------------------------------------
+**  Compilée seulement avec -DPOKE3D_TRACE (make TRACE=1); activée au
+**  lancement par POKE3D_TRACE=fichier.json. Les moyennes du profileur
+**  cachent les à-coups: la trace garde chaque début/fin de zone avec son
+**  thread (loop_hook, move_and_rotate, étapes de rendu, tuiles de chaque
+**  worker, present, drain des événements X), lisible dans chrome://tracing
+**  ou ui.perfetto.dev.
+**
+**  Chaque worker écrit seulement dans son propre tampon (index = worker):
+**  pas de verrou ni d'atomique sur le chemin chaud. Entre deux frames,
+**  quand tous les workers attendent le prochain pool_run et qu'un tampon
+**  est à moitié plein, le thread principal échange les tampons pleins
+**  contre des vides et réveille le thread d'écriture: le fprintf ne se
+**  fait jamais dans loop_hook. Si l'écriture précédente n'est pas finie,
+**  l'échange attend la frame suivante (les tampons continuent de se
+**  remplir, au pire des zones sont perdues).
+**
+**  Tampon plein: un 'B' n'est accepté que s'il reste de la place pour
+**  lui et pour le 'E' de chaque zone ouverte; sinon la zone est perdue
+**  avec tout ce qu'elle contient, fin comprise (pas de zone sans fin,
+**  que le viewer étirerait jusqu'au bout de la trace).
+**
+**  trace_init  : ouvre le fichier, deux tampons par worker, noms des
+**                threads, lance le thread d'écriture
+**  trace_event : ajoute un événement au tampon du worker (paires perdues
+**                ensemble si plein)
+**  trace_flush : confie les tampons au thread d'écriture (force: écrit
+**                tout sur place, thread d'écriture arrêté)
+**  trace_close : arrêt du thread, dernier vidage, fin du JSON, fermeture
+** ========================================================================== */
+
+#ifdef POKE3D_TRACE
+
+static void trace_write(t_trace *t, const char *json)
+{
+    fprintf((FILE *)t->f, "%s\n    %s", t->written ? "," : "", json);
+    t->written++;
+}
+
+/* Événements ev[0, n) du worker w en JSON */
+static void trace_write_buf(t_trace *t, int w, const t_trace_ev *ev, int n)
+{
+    const t_trace_ev    *e;
+    char                line[192];
+    int                 i;
+
+    i = 0;
+    while (i < n)
+    {
+        e = &ev[i++];
+        if (e->x0 >= 0)
+            snprintf(line, sizeof(line), "{\"name\": \"%s\", \"ph\": \"%c\", "
+                     "\"pid\": 1, \"tid\": %d, \"ts\": %.3f, "
+                     "\"args\": {\"x0\": %d, \"x1\": %d}}",
+                     e->name, e->ph, w, e->ts / 1e3, e->x0, e->x1);
+        else
+            snprintf(line, sizeof(line), "{\"name\": \"%s\", \"ph\": \"%c\", "
+                     "\"pid\": 1, \"tid\": %d, \"ts\": %.3f}",
+                     e->name, e->ph, w, e->ts / 1e3);
+        trace_write(t, line);
+    }
+}
+
+/* Thread d'écriture: les tampons out confiés par trace_flush */
+static void *trace_writer(void *arg)
+{
+    t_trace *t = (t_trace *)arg;
+    int     w;
+
+    pthread_mutex_lock(&t->mu);
+    while (1)
+    {
+        while (!t->pending && !t->stop)
+            pthread_cond_wait(&t->cv, &t->mu);
+        if (!t->pending)
+            break ;
+        pthread_mutex_unlock(&t->mu);
+        w = 0;
+        while (w < t->nbufs)
+        {
+            trace_write_buf(t, w, t->bufs[w].out, t->bufs[w].out_n);
+            t->bufs[w].out_n = 0;
+            w++;
+        }
+        fflush((FILE *)t->f);
+        pthread_mutex_lock(&t->mu);
+        t->pending = false;
+    }
+    pthread_mutex_unlock(&t->mu);
+    return (NULL);
+}
+
+void    trace_init(t_game *g)
+{
+    t_trace     *t = &g->trace;
+    const char  *path = getenv("POKE3D_TRACE");
+    char        meta[128];
+    int         i;
+
+    __builtin_memset(t, 0, sizeof(*t));
+    if (!path || !*path)
+        return ;
+    t->f = fopen(path, "w");
+    t->nbufs = g->pool.count;
+    t->bufs = (t_trace_buf *)calloc(t->nbufs, sizeof(t_trace_buf));
+    i = 0;
+    while (t->f && t->bufs && i < t->nbufs)
+    {
+        t->bufs[i].ev = (t_trace_ev *)malloc(sizeof(t_trace_ev) * TRACE_CAP);
+        t->bufs[i].out = (t_trace_ev *)malloc(sizeof(t_trace_ev) * TRACE_CAP);
+        if (!t->bufs[i].ev || !t->bufs[i++].out)
+            break ;
+    }
+    if (!t->f || !t->bufs || !t->bufs[t->nbufs - 1].out)
+    {
+        fprintf(stderr, "poke3d: trace disabled (cannot open %s)\n", path);
+        trace_close(t);
+        return ;
+    }
+    t->t0 = clock_ns();
+    fprintf((FILE *)t->f, "{\n  \"displayTimeUnit\": \"ms\",\n  \"traceEvents\": [");
+    i = 0;
+    while (i < t->nbufs)
+    {
+        snprintf(meta, sizeof(meta), "{\"name\": \"thread_name\", \"ph\": \"M\", "
+                 "\"pid\": 1, \"tid\": %d, \"args\": {\"name\": \"%s %d\"}}",
+                 i, i ? "worker" : "main", i);
+        trace_write(t, meta);
+        i++;
+    }
+    pthread_mutex_init(&t->mu, NULL);
+    pthread_cond_init(&t->cv, NULL);
+    t->writer_on = (pthread_create(&t->writer, NULL, trace_writer, t) == 0);
+}
+
+void    trace_event(t_trace *t, int worker, const char *name, char ph, int x0, int x1)
+{
+    t_trace_buf *b;
+    t_trace_ev  *e;
+
+    if (!t->bufs || worker < 0 || worker >= t->nbufs)
+        return ;
+    b = &t->bufs[worker];
+    if (ph == 'B')
+    {
+        b->depth++;
+        /* Place pour ce 'B' et le 'E' de chaque zone ouverte, celle-ci
+           comprise (depth zones acceptées quand skip == 0) */
+        if (!b->skip && b->n + 1 + b->depth > TRACE_CAP)
+            b->skip = b->depth;
+    }
+    if (b->skip)
+    {
+        b->dropped++;
+        if (ph == 'E' && b->depth-- == b->skip)
+            b->skip = 0;
+        return ;
+    }
+    if (ph == 'E')
+        b->depth--;
+    e = &b->ev[b->n++];
+    e->ts = clock_ns() - t->t0;
+    e->name = name;
+    e->ph = ph;
+    e->x0 = x0;
+    e->x1 = x1;
+}
+
+/* Appelé sur le thread principal entre deux frames: les workers sont tous
+   bloqués dans le pool, leurs tampons ne bougent pas. */
+void    trace_flush(t_trace *t, bool force)
+{
+    t_trace_ev  *ev;
+    int         w;
+
+    if (!t->bufs)
+        return ;
+    if (force)
+    {
+        w = 0;
+        while (w < t->nbufs)
+        {
+            trace_write_buf(t, w, t->bufs[w].ev, t->bufs[w].n);
+            t->bufs[w++].n = 0;
+        }
+        return ;
+    }
+    w = 0;
+    while (w < t->nbufs && t->bufs[w].n < TRACE_CAP / 2)
+        w++;
+    if (w == t->nbufs || !t->writer_on)
+        return ;
+    pthread_mutex_lock(&t->mu);
+    if (!t->pending)
+    {
+        w = 0;
+        while (w < t->nbufs)
+        {
+            ev = t->bufs[w].out;
+            t->bufs[w].out = t->bufs[w].ev;
+            t->bufs[w].out_n = t->bufs[w].n;
+            t->bufs[w].ev = ev;
+            t->bufs[w++].n = 0;
+        }
+        t->pending = true;
+        pthread_cond_signal(&t->cv);
+    }
+    pthread_mutex_unlock(&t->mu);
+}
+
+void    trace_close(t_trace *t)
+{
+    int dropped;
+    int i;
+
+    dropped = 0;
+    if (t->writer_on)
+    {
+        /* Le thread finit l'écriture en cours avant de s'arrêter */
+        pthread_mutex_lock(&t->mu);
+        t->stop = true;
+        pthread_cond_signal(&t->cv);
+        pthread_mutex_unlock(&t->mu);
+        pthread_join(t->writer, NULL);
+        pthread_mutex_destroy(&t->mu);
+        pthread_cond_destroy(&t->cv);
+    }
+    if (t->f && t->bufs)
+    {
+        trace_flush(t, true);
+        fprintf((FILE *)t->f, "\n  ]\n}\n");
+    }
+    if (t->f)
+        fclose((FILE *)t->f);
+    i = 0;
+    while (t->bufs && i < t->nbufs)
+    {
+        dropped += t->bufs[i].dropped;
+        free(t->bufs[i].ev);
+        free(t->bufs[i++].out);
+    }
+    if (dropped)
+        fprintf(stderr, "poke3d: trace: %d events dropped (buffer full)\n", dropped);
+    free(t->bufs);
+    __builtin_memset(t, 0, sizeof(*t));
+}
+
+#endif
@@ -0,0 +1,233 @@
+#include "game.h"
+#include <unistd.h>   /* write(), etc. */
+#include <string.h>   /* strlen(), memset() */
+#include <stdio.h>    /* snprintf() pour le helper de chargement */
+#include <time.h>     /* clock_gettime() */
+
+/* Définitions uniques des globales déclarées "extern" dans game.h */
+t_tex      tex_pokeball;
+t_tex      tex_pokeball_small;
+t_sprite_runs pokeball_runs;
+t_sprite  *sprites;
+int        sprite_count;
+int        collected;
+float     *zbuf;
+
+/* ==========================================================================
+**  Helpers — erreurs & pixels
+**  --------------------------------------------------------------------------
+**  panic       : affiche un message d'erreur sur stderr et quitte le programme
+**  rgb         : compose un entier 0xRRGGBB depuis des composantes 0..255
+**  put_pixel   : écrit un pixel (couleur) dans une image MLX (framebuffer)
+**  clock_ns    : horloge monotone en nanosecondes (mesures, cadences, bench)
+** ========================================================================== */
+
+void    panic(const char *msg)
+{
+    /* Écrit le message d'erreur sur la sortie d'erreur (descripteur 2) */
+    write(2, msg, strlen(msg));
+    write(2, "\n", 1);
+    /* Termine le programme avec un code de sortie d'erreur */
+    exit(1);
+}
+
+int     rgb(int r, int g, int b)
+{
+    /* Sécurise les bornes des composantes entre 0 et 255
+       (évite des dépassements si le calcul d'une couleur sort de l'intervalle) */
+    if (r < 0) r = 0;
+    if (r > 255) r = 255;
+    if (g < 0) g = 0;
+    if (g > 255) g = 255;
+    if (b < 0) b = 0;
+    if (b > 255) b = 255;
+    /* Pack 3 octets R, G, B dans un entier 0xRRGGBB (format attendu par MLX) */
+    return (r << 16) | (g << 8) | b;
+}
+
+void    put_pixel(t_img *img, int x, int y, int color)
+{
+    char *p;
+
+    /* Ignore toute écriture hors-bord pour éviter un segfault */
+    if (x < 0 || x >= img->w || y < 0 || y >= img->h)
+        return ;
+    /* Calcule l'adresse du pixel (ligne + colonne * taille pixel) */
+    p = img->addr + (y * img->line_len + x * (img->bpp / 8));
+    /* Écrit la couleur (int 0xRRGGBB) dans l'image MLX */
+    *(int *)p = color;
+}
+
+long long   clock_ns(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ((long long)ts.tv_sec * 1000000000LL + ts.tv_nsec);
+}
+
+/* ==========================================================================
+**  Frame / Textures
+**  --------------------------------------------------------------------------
+**  try_load_xpm_paths : tente de charger un XPM depuis plusieurs chemins
+**  create_frame: crée l'image de l'écran (g->screen) via le backend
+**  destroy_frame: détruit la cible de rendu et l'image de la fenêtre
+**  game_resize : change la taille de l'écran et de tout ce qui en dépend
+**  load_xpm    : charge un fichier XPM dans une structure t_tex
+**  tex_apply_layout : prépare la copie transposée d'une texture TEX_COL_MAJOR
+**  tex_procedural : texture de secours générée en mémoire
+**  destroy_tex : libère une texture
+** ========================================================================== */
+
+/* Essaie plusieurs emplacements standards pour trouver l’asset.
+   - file       : nom du fichier (ex. "sky.xpm")
+   - cand[]     : liste d'emplacements tentés ("src/", "assets/", etc.)
+   - On concatène le chemin + fichier dans buf, puis on teste load_xpm.
+   - Renvoie 1 si succès, 0 sinon. */
+int     try_load_xpm_paths(t_game *g, t_tex *dst, const char *file)
+{
+    const char  *cand[] = { file, "src/", "assets/", "./src/", "./assets/", NULL };
+    char        buf[512];
+    int         i;
+    size_t      n;
+
+    i = 0;
+    while (cand[i])
+    {
+        n = strlen(cand[i]);
+        if (n && cand[i][n - 1] == '/')
+            snprintf(buf, sizeof(buf), "%s%s", cand[i], file);
+        else
+            snprintf(buf, sizeof(buf), "%s", cand[i]);
+        if (load_xpm(g, dst, buf))
+            return (1);
+        i++;
+    }
+    return (0);
+}
+
+/* Crée l'image de l'écran (g->screen) de taille (w,h) via le backend
+   (image MLX ou buffer mémoire), plus sa table de lignes pour l'API span.
+   La cible de rendu g->frame est créée ensuite par rt_resize. */
+int     create_frame(t_game *g, int w, int h)
+{
+    if (!g->be->screen_new(g, w, h))
+        return (0);
+    return (img_rows_build(&g->screen, (unsigned int *)g->screen.addr,
+                           1, g->screen.line_len / 4));
+}
+
+/* Détruit la cible de rendu puis l'image de l'écran (si elle existe) */
+void    destroy_frame(t_game *g)
+{
+    rt_free(g);
+    if (g->screen.addr)
+        g->be->screen_free(g);
+    g->screen.img = NULL;
+    g->screen.addr = NULL;
+    img_rows_free(&g->screen);
+}
+
+/* Change la taille de l'écran sans redémarrer: nouvelle image, puis cible de
+   rendu, scheduler et tables par colonne / par ligne refaits à la nouvelle
+   taille (au palier courant du gouverneur). La fenêtre MLX elle-même est
+   recréée par l'appelant (main.c), MiniLibX ne sachant pas la redimensionner. */
+int     game_resize(t_game *g, int w, int h)
+{
+    if (w < RES_MIN) w = RES_MIN;
+    if (h < RES_MIN) h = RES_MIN;
+    if (w > RES_MAX) w = RES_MAX;
+    if (h > RES_MAX) h = RES_MAX;
+    destroy_frame(g);
+    if (!create_frame(g, w, h) || !rt_fit(g))
+        return (0);
+    g->win_w = w;
+    g->win_h = h;
+    render_invalidate(g, DIRTY_ALL);
+    return (1);
+}
+
+/* Charge un fichier XPM sur disque dans une structure t_tex, via le
+   backend (mlx_xpm_file_to_image, ou lecteur XPM intégré sans X). */
+int     load_xpm(t_game *g, t_tex *dst, const char *path)
+{
+    if (!g->be->tex_load(g, dst, path))
+        return (0);
+    /* La disposition est une propriété de la texture, fixée avant le chargement */
+    return (tex_apply_layout(dst));
+}
+
+/* Si la texture est TEX_COL_MAJOR, copie ses texels transposés dans un
+   buffer 32 bits privé: px[u * h + v] = texel (u, v). Une colonne de
+   texture devient contiguë en mémoire. Sans effet en TEX_ROW_MAJOR. */
+int     tex_apply_layout(t_tex *t)
+{
+    int u;
+    int v;
+
+    free(t->px);
+    t->px = NULL;
+    if (t->layout != TEX_COL_MAJOR)
+        return (1);
+    t->px = (unsigned int *)malloc(sizeof(unsigned int) * t->w * t->h);
+    if (!t->px)
+        return (0);
+    v = 0;
+    while (v < t->h)
+    {
+        const unsigned int *row = (const unsigned int *)(t->addr + v * t->line_len);
+        u = 0;
+        while (u < t->w)
+        {
+            t->px[u * t->h + v] = row[u * (t->bpp / 32)];
+            u++;
+        }
+        v++;
+    }
+    return (1);
+}
+
+/* Texture de secours (damier 8x8 bruité) quand un fichier manque: pixels
+   en mémoire, t->img reste NULL. Applique la disposition demandée. */
+int     tex_procedural(t_tex *t, int w, int h, int seed)
+{
+    int x;
+    int y;
+
+    t->img = NULL;
+    t->w = w;
+    t->h = h;
+    t->bpp = 32;
+    t->line_len = w * 4;
+    t->addr = (char *)malloc((size_t)w * h * 4);
+    if (!t->addr)
+        return (0);
+    y = 0;
+    while (y < h)
+    {
+        x = 0;
+        while (x < w)
+        {
+            int base = (((x >> 3) ^ (y >> 3)) & 1) ? 0x9A8060 : 0x5A7040;
+            int noise = (int)(((unsigned)x * 73856093u ^ (unsigned)y * 19349663u
+                               ^ (unsigned)seed) & 0x1F);
+            ((int *)t->addr)[y * w + x] = base + (noise << 16) + (noise << 8) + noise;
+            x++;
+        }
+        y++;
+    }
+    return (tex_apply_layout(t));
+}
+
+/* Libère une texture: image du backend, ou pixels en mémoire */
+void    destroy_tex(t_game *g, t_tex *t)
+{
+    if (t->img)
+        g->be->tex_free(g, t);
+    else
+        free(t->addr);
+    t->img = NULL;
+    t->addr = NULL;
+    free(t->px);
+    t->px = NULL;
+}
@@ -0,0 +1,695 @@
+#include "game.h"
+#include <fcntl.h>      /* open() */
+#include <stdio.h>      /* fprintf() pour les erreurs de fichier */
+#include <unistd.h>     /* pread(), pwrite(), close(), usleep() */
+
+/* ==========================================================================
+**  Monde en chunks — carte paginée depuis le disque
+**  --------------------------------------------------------------------------
+**  Fichier (entiers natifs, x86):
+**    - en-tête de 64 octets: "P3DWORLD", version, côté d'un chunk
+**      (WORLD_CHUNK), largeur et hauteur en chunks, départ (case, degrés)
+**    - index: un entier 64 bits par chunk, ligne par ligne:
+**      WORLD_EMPTY (que du sol), WORLD_FULL (que des murs), sinon la
+**      position des données du chunk dans le fichier
+**    - données: WORLD_CHUNK lignes de 64 bits, bit x = mur en x
+**  Un chunk coûte deux pread (entrée d'index, puis données), rien n'est
+**  gardé du fichier en mémoire: la taille du monde n'est bornée que par
+**  l'index (clé = cy * cw + cx sur un int).
+**
+**  En mémoire, g->grid n'est qu'une fenêtre de WORLD_SPAN² chunks autour
+**  du joueur; la DDA, les collisions et la pyramide la lisent comme une
+**  carte ordinaire. Un chunk de la fenêtre pas encore lu reste plein:
+**  les rayons s'arrêtent sur sa face (mur de brouillard) et le joueur ne
+**  peut pas y entrer, sans jamais attendre le disque. Le bord plein de la
+**  grille borne la vue à WORLD_RADIUS chunks au moins.
+**
+**  Quand le joueur change de chunk, la fenêtre est recentrée: nouvelle
+**  grille où les chunks déjà présents sont recopiés, les autres pris du
+**  cache ou laissés en brouillard; p.pos est décalé d'autant (origine
+**  flottante: les coordonnées restent petites, les flottants précis).
+**
+**  Cache: slots de chunks lus, chaînés en LRU et accrochés à un hachage
+**  (clé & masque, les clés voisines tombent dans des cases différentes);
+**  le nombre de slots vient du budget POKE3D_WORLD_MB (WORLD_CACHE_MB par
+**  défaut). Un slot en lecture n'est ni dans la LRU ni évictable.
+**
+**  Thread de lecture: prend les demandes dans l'ordre (file req), lit le
+**  chunk hors verrou, le rend par la liste done. world_update (fil
+**  principal, entre deux frames) copie les chunks arrivés dans la
+**  fenêtre, puis demande les chunks en brouillard du plus proche au plus
+**  lointain, et ceux des fenêtres à 1..WORLD_AHEAD chunks devant le
+**  joueur selon p.vel (préchargement, au plus la moitié de la file: pas
+**  de lecture pour les côtés qu'il ne verra pas).
+**
+**  world_open   : ouvre le fichier, lit la première fenêtre (bloquant, une
+**                 seule fois), place le joueur, lance le thread
+**  world_update : un tick: chunks arrivés, recentrage, demandes
+**  world_close  : arrête le thread et libère le cache (via map_free)
+**  world_write  : écrit un monde chunk par chunk depuis un générateur
+**  world_save   : écrit la carte chargée en monde (--save-world)
+** ========================================================================== */
+
+#define WORLD_MAGIC     "P3DWORLD"
+#define WORLD_VERSION   1
+#define WORLD_EMPTY     0ull
+#define WORLD_FULL      1ull
+#define WORLD_MAX_SIDE  32768   /* chunks par côté */
+#define WORLD_CELLS     (WORLD_SPAN * WORLD_CHUNK)
+
+typedef struct s_world_head
+{
+    char            magic[8];
+    unsigned int    version;
+    unsigned int    chunk;
+    unsigned int    cw;
+    unsigned int    ch;
+    int             sx;
+    int             sy;
+    float           deg;
+    unsigned int    pad[7];
+}   t_world_head;
+
+/* Octet b de lignes de bits -> 8 cases 0 / 1 (bit k -> octet k) */
+static unsigned long long   g_spread[256];
+
+static void spread_init(void)
+{
+    int b;
+    int k;
+
+    b = 0;
+    while (b < 256)
+    {
+        g_spread[b] = 0;
+        k = 0;
+        while (k < 8)
+        {
+            if (b & (1 << k))
+                g_spread[b] |= 1ull << (8 * k);
+            k++;
+        }
+        b++;
+    }
+}
+
+/* Lignes du chunk key (erreur de lecture: plein) */
+static void chunk_read(t_world *w, int key, unsigned long long *rows)
+{
+    unsigned long long  at;
+    off_t               off;
+
+    off = (off_t)sizeof(t_world_head) + (off_t)key * 8;
+    if (pread(w->fd, &at, 8, off) != 8)
+        at = WORLD_FULL;
+    if (at == WORLD_EMPTY || at == WORLD_FULL)
+        __builtin_memset(rows, at == WORLD_FULL ? 0xFF : 0, 8 * WORLD_CHUNK);
+    else if (pread(w->fd, rows, 8 * WORLD_CHUNK, (off_t)at) != 8 * WORLD_CHUNK)
+        __builtin_memset(rows, 0xFF, 8 * WORLD_CHUNK);
+}
+
+/* Thread de lecture: une demande à la fois, lue hors verrou */
+static void *world_loader(void *arg)
+{
+    t_world *w = (t_world *)arg;
+    int     s;
+
+    pthread_mutex_lock(&w->mu);
+    while (1)
+    {
+        while (!w->stop && w->req_n == 0)
+            pthread_cond_wait(&w->cv, &w->mu);
+        if (w->stop)
+            break ;
+        s = w->req[w->req_head];
+        w->req_head = (w->req_head + 1) % WORLD_QUEUE;
+        w->req_n--;
+        pthread_mutex_unlock(&w->mu);
+        if (w->delay_us > 0)
+            usleep(w->delay_us);
+        chunk_read(w, w->slots[s].key, w->slots[s].rows);
+        pthread_mutex_lock(&w->mu);
+        w->done[w->done_n++] = s;
+    }
+    pthread_mutex_unlock(&w->mu);
+    return (NULL);
+}
+
+/* ---- Cache: hachage + LRU ----------------------------------------------- */
+
+static int  cache_find(const t_world *w, int key)
+{
+    int s;
+
+    s = w->bucket[key & w->bucket_mask];
+    while (s >= 0 && w->slots[s].key != key)
+        s = w->slots[s].hnext;
+    return (s);
+}
+
+static void lru_unlink(t_world *w, int s)
+{
+    t_chunk_slot    *c = &w->slots[s];
+
+    if (c->prev >= 0)
+        w->slots[c->prev].next = c->next;
+    else
+        w->lru_head = c->next;
+    if (c->next >= 0)
+        w->slots[c->next].prev = c->prev;
+    else
+        w->lru_tail = c->prev;
+}
+
+static void lru_push(t_world *w, int s)
+{
+    w->slots[s].prev = -1;
+    w->slots[s].next = w->lru_head;
+    if (w->lru_head >= 0)
+        w->slots[w->lru_head].prev = s;
+    else
+        w->lru_tail = s;
+    w->lru_head = s;
+}
+
+/* Slot libre, sinon le moins récemment utilisé (décroché du hachage);
+   -1 si tous sont en lecture */
+static int  cache_take(t_world *w, int key)
+{
+    int *link;
+    int s;
+
+    s = w->free_head;
+    if (s >= 0)
+        w->free_head = w->slots[s].next;
+    else if ((s = w->lru_tail) >= 0)
+    {
+        lru_unlink(w, s);
+        link = &w->bucket[w->slots[s].key & w->bucket_mask];
+        while (*link != s)
+            link = &w->slots[*link].hnext;
+        *link = w->slots[s].hnext;
+        w->evictions++;
+    }
+    else
+        return (-1);
+    w->slots[s].key = key;
+    w->slots[s].ready = 0;
+    w->slots[s].hnext = w->bucket[key & w->bucket_mask];
+    w->bucket[key & w->bucket_mask] = s;
+    return (s);
+}
+
+/* Demande de lecture du chunk (cx, cy) du monde; 0 si la file est pleine */
+static int  cache_request(t_world *w, int cx, int cy)
+{
+    const int   key = cy * w->cw + cx;
+    int         s;
+
+    if (cache_find(w, key) >= 0)
+        return (1);
+    if (w->loading >= WORLD_QUEUE || (s = cache_take(w, key)) < 0)
+        return (0);
+    w->loading++;
+    pthread_mutex_lock(&w->mu);
+    w->req[(w->req_head + w->req_n) % WORLD_QUEUE] = s;
+    w->req_n++;
+    pthread_cond_signal(&w->cv);
+    pthread_mutex_unlock(&w->mu);
+    return (1);
+}
+
+/* ---- Fenêtre ------------------------------------------------------------ */
+
+/* Chunk (i, j) de la fenêtre: lignes de bits -> cases du plan solid */
+static void chunk_blit(t_grid *gr, int i, int j, const unsigned long long *rows)
+{
+    unsigned char       *dst;
+    unsigned long long  r;
+    int                 y;
+    int                 k;
+
+    y = 0;
+    while (y < WORLD_CHUNK)
+    {
+        dst = &GRID_SOLID(gr, i * WORLD_CHUNK, j * WORLD_CHUNK + y);
+        r = rows[y];
+        k = 0;
+        while (k < WORLD_CHUNK)
+        {
+            __builtin_memcpy(dst + k, &g_spread[r & 0xFF], 8);
+            r >>= 8;
+            k += 8;
+        }
+        y++;
+    }
+}
+
+/* Chunk (i, j) de la fenêtre depuis le slot s: copié, pyramide à jour */
+static void chunk_show(t_game *g, int i, int j, int s)
+{
+    chunk_blit(&g->grid, i, j, g->world.slots[s].rows);
+    g->world.state[j * WORLD_SPAN + i] = WCHUNK_LOADED;
+    mip_update_rect(&g->grid, i * WORLD_CHUNK, j * WORLD_CHUNK,
+                    i * WORLD_CHUNK + WORLD_CHUNK - 1, j * WORLD_CHUNK + WORLD_CHUNK - 1);
+}
+
+/* Chunks rendus par le thread: dans la LRU, et dans la fenêtre s'ils y
+   sont encore attendus */
+static void world_drain(t_game *g)
+{
+    t_world *w = &g->world;
+    int     done[WORLD_QUEUE];
+    int     n;
+    int     s;
+    int     i;
+    int     j;
+
+    pthread_mutex_lock(&w->mu);
+    n = w->done_n;
+    __builtin_memcpy(done, w->done, sizeof(int) * n);
+    w->done_n = 0;
+    pthread_mutex_unlock(&w->mu);
+    while (n-- > 0)
+    {
+        s = done[n];
+        w->slots[s].ready = 1;
+        lru_push(w, s);
+        w->loading--;
+        w->reads++;
+        i = w->slots[s].key % w->cw - w->ox;
+        j = w->slots[s].key / w->cw - w->oy;
+        if (i >= 0 && j >= 0 && i < WORLD_SPAN && j < WORLD_SPAN
+            && w->state[j * WORLD_SPAN + i] == WCHUNK_FOG)
+        {
+            chunk_show(g, i, j, s);
+            render_invalidate(g, DIRTY_MAP);
+        }
+    }
+}
+
+/* Plans d'une fenêtre vide: tout plein, champ de distance à zéro (aucun
+   saut par le champ, toujours exact) */
+static int  window_alloc(t_grid *gr)
+{
+    if (!grid_alloc(gr, WORLD_CELLS, WORLD_CELLS))
+        return (0);
+    __builtin_memset(gr->field, 0, (size_t)gr->stride * (WORLD_CELLS + 2) + 4);
+    return (1);
+}
+
+/* État initial du chunk (i, j) d'une fenêtre d'origine (ox, oy): hors du
+   monde, déjà dans le cache (copié), ou brouillard */
+static void window_fill(t_game *g, t_grid *gr, int i, int j)
+{
+    t_world     *w = &g->world;
+    const int   cx = w->ox + i;
+    const int   cy = w->oy + j;
+    int         s;
+
+    w->state[j * WORLD_SPAN + i] = WCHUNK_FOG;
+    if (cx < 0 || cy < 0 || cx >= w->cw || cy >= w->ch)
+        w->state[j * WORLD_SPAN + i] = WCHUNK_OUTSIDE;
+    else if ((s = cache_find(w, cy * w->cw + cx)) >= 0 && w->slots[s].ready)
+    {
+        chunk_blit(gr, i, j, w->slots[s].rows);
+        w->state[j * WORLD_SPAN + i] = WCHUNK_LOADED;
+        lru_unlink(w, s);
+        lru_push(w, s);
+        w->hits++;
+    }
+}
+
+/* Joueur sorti du chunk central: fenêtre décalée de (dx, dy) chunks */
+static void world_shift(t_game *g, int dx, int dy)
+{
+    t_world         *w = &g->world;
+    unsigned char   old[WORLD_SPAN * WORLD_SPAN];
+    t_grid          gr;
+    int             i;
+    int             j;
+    int             y;
+
+    __builtin_memset(&gr, 0, sizeof(gr));
+    if (!window_alloc(&gr))
+        panic("malloc world window");
+    __builtin_memcpy(old, w->state, sizeof(old));
+    w->ox += dx;
+    w->oy += dy;
+    j = 0;
+    while (j < WORLD_SPAN)
+    {
+        i = 0;
+        while (i < WORLD_SPAN)
+        {
+            if (i + dx >= 0 && j + dy >= 0 && i + dx < WORLD_SPAN && j + dy < WORLD_SPAN
+                && old[(j + dy) * WORLD_SPAN + i + dx] == WCHUNK_LOADED)
+            {
+                y = 0;
+                while (y < WORLD_CHUNK)
+                {
+                    __builtin_memcpy(&GRID_SOLID(&gr, i * WORLD_CHUNK, j * WORLD_CHUNK + y),
+                                     &GRID_SOLID(&g->grid, (i + dx) * WORLD_CHUNK,
+                                                 (j + dy) * WORLD_CHUNK + y), WORLD_CHUNK);
+                    y++;
+                }
+                w->state[j * WORLD_SPAN + i] = WCHUNK_LOADED;
+            }
+            else
+                window_fill(g, &gr, i, j);
+            i++;
+        }
+        j++;
+    }
+    free(g->grid.solid);
+    free(g->grid.attr);
+    free(g->grid.field);
+    mip_free(&g->grid);
+    g->grid = gr;
+    if (!mip_build(&g->grid, WORLD_CELLS))
+        panic("malloc grid");
+    g->p.pos.x -= (float)(dx * WORLD_CHUNK);
+    g->p.pos.y -= (float)(dy * WORLD_CHUNK);
+    w->shifts++;
+    render_invalidate(g, DIRTY_MAP | DIRTY_CAMERA);
+}
+
+/* Chunks en brouillard de la fenêtre, anneau par anneau depuis le centre */
+static void world_want(t_game *g)
+{
+    t_world *w = &g->world;
+    int     r;
+    int     i;
+    int     j;
+
+    r = 0;
+    while (r <= WORLD_RADIUS)
+    {
+        j = WORLD_RADIUS - r;
+        while (j <= WORLD_RADIUS + r)
+        {
+            i = WORLD_RADIUS - r;
+            while (i <= WORLD_RADIUS + r)
+            {
+                if (w->state[j * WORLD_SPAN + i] == WCHUNK_FOG
+                    && !cache_request(w, w->ox + i, w->oy + j))
+                    return ;
+                /* Lignes intérieures de l'anneau: seulement ses deux bords */
+                i += (j == WORLD_RADIUS - r || j == WORLD_RADIUS + r || i == WORLD_RADIUS + r)
+                     ? 1 : 2 * r;
+            }
+            j++;
+        }
+        r++;
+    }
+}
+
+/* Fenêtres qu'occupera le joueur après 1..ahead chunks de marche selon
+   p.vel (arrondi à l'une des 8 directions): leurs chunks hors de la
+   fenêtre courante, les plus proches d'abord */
+static void world_prefetch(t_game *g)
+{
+    t_world     *w = &g->world;
+    const float v = sqrtf(g->p.vel.x * g->p.vel.x + g->p.vel.y * g->p.vel.y);
+    const int   ux = (g->p.vel.x > 0.38f * v) - (g->p.vel.x < -0.38f * v);
+    const int   uy = (g->p.vel.y > 0.38f * v) - (g->p.vel.y < -0.38f * v);
+    int         s;
+    int         i;
+    int         j;
+
+    if (w->ahead <= 0 || v <= 0.0f)
+        return ;
+    s = 1;
+    while (s <= w->ahead)
+    {
+        j = s * uy;
+        while (j < s * uy + WORLD_SPAN)
+        {
+            i = s * ux;
+            while (i < s * ux + WORLD_SPAN)
+            {
+                if (w->loading >= WORLD_QUEUE / 2)
+                    return ;
+                if ((i < 0 || j < 0 || i >= WORLD_SPAN || j >= WORLD_SPAN)
+                    && w->ox + i >= 0 && w->oy + j >= 0
+                    && w->ox + i < w->cw && w->oy + j < w->ch)
+                    cache_request(w, w->ox + i, w->oy + j);
+                i++;
+            }
+            j++;
+        }
+        s++;
+    }
+}
+
+void    world_update(t_game *g)
+{
+    const int   cx = (int)g->p.pos.x / WORLD_CHUNK;
+    const int   cy = (int)g->p.pos.y / WORLD_CHUNK;
+
+    world_drain(g);
+    if (cx != WORLD_RADIUS || cy != WORLD_RADIUS)
+        world_shift(g, cx - WORLD_RADIUS, cy - WORLD_RADIUS);
+    world_want(g);
+    world_prefetch(g);
+}
+
+/* ---- Ouverture / fermeture ---------------------------------------------- */
+
+static int  world_error(t_game *g, const char *path, const char *msg)
+{
+    fprintf(stderr, "poke3d: %s: %s\n", path, msg);
+    world_close(g);
+    return (0);
+}
+
+/* Cache à la taille du budget (Mo, fractions permises): slots + cases du
+   hachage (puissance de 2 au plus égale au nombre de slots); 2 ×
+   WORLD_QUEUE slots au moins */
+static int  cache_alloc(t_world *w)
+{
+    const char  *env = getenv("POKE3D_WORLD_MB");
+    long long   budget;
+    int         n;
+    int         s;
+
+    budget = (long long)WORLD_CACHE_MB << 20;
+    if (env && strtod(env, NULL) > 0.0)
+        budget = (long long)(strtod(env, NULL) * (1 << 20));
+    n = (int)(budget / (long long)(sizeof(t_chunk_slot) + sizeof(int)));
+    if (n < 2 * WORLD_QUEUE)
+        n = 2 * WORLD_QUEUE;
+    w->bucket_mask = 1;
+    while (w->bucket_mask * 2 <= n)
+        w->bucket_mask *= 2;
+    w->slots = (t_chunk_slot *)malloc(sizeof(t_chunk_slot) * n);
+    w->bucket = (int *)malloc(sizeof(int) * w->bucket_mask);
+    if (!w->slots || !w->bucket)
+        return (0);
+    __builtin_memset(w->bucket, 0xFF, sizeof(int) * w->bucket_mask);
+    w->bucket_mask--;
+    w->slot_count = n;
+    s = 0;
+    while (s < n)
+    {
+        w->slots[s].key = -1;
+        w->slots[s].next = (s + 1 < n) ? s + 1 : -1;
+        s++;
+    }
+    w->free_head = 0;
+    w->lru_head = -1;
+    w->lru_tail = -1;
+    return (1);
+}
+
+/* Première fenêtre autour du départ, lue sur place */
+static void world_first(t_game *g, const t_world_head *hd)
+{
+    t_world *w = &g->world;
+    int     s;
+    int     i;
+    int     j;
+
+    w->ox = hd->sx / WORLD_CHUNK - WORLD_RADIUS;
+    w->oy = hd->sy / WORLD_CHUNK - WORLD_RADIUS;
+    j = 0;
+    while (j < WORLD_SPAN)
+    {
+        i = 0;
+        while (i < WORLD_SPAN)
+        {
+            window_fill(g, &g->grid, i, j);
+            if (w->state[j * WORLD_SPAN + i] == WCHUNK_FOG
+                && (s = cache_take(w, (w->oy + j) * w->cw + w->ox + i)) >= 0)
+            {
+                chunk_read(w, w->slots[s].key, w->slots[s].rows);
+                w->slots[s].ready = 1;
+                lru_push(w, s);
+                w->reads++;
+                chunk_blit(&g->grid, i, j, w->slots[s].rows);
+                w->state[j * WORLD_SPAN + i] = WCHUNK_LOADED;
+            }
+            i++;
+        }
+        j++;
+    }
+    setup_player(g, (float)(hd->sx - w->ox * WORLD_CHUNK),
+                 (float)(hd->sy - w->oy * WORLD_CHUNK), hd->deg);
+}
+
+int     world_open(t_game *g, const char *path)
+{
+    t_world         *w = &g->world;
+    t_world_head    hd;
+    const char      *env = getenv("POKE3D_WORLD_DELAY_US");
+
+    map_free(g);
+    __builtin_memset(w, 0, sizeof(*w));
+    w->fd = open(path, O_RDONLY);
+    if (w->fd < 0 || pread(w->fd, &hd, sizeof(hd), 0) != (ssize_t)sizeof(hd))
+        return (world_error(g, path, "cannot read world"));
+    if (__builtin_memcmp(hd.magic, WORLD_MAGIC, 8) || hd.version != WORLD_VERSION
+        || hd.chunk != WORLD_CHUNK || hd.cw < 1 || hd.ch < 1
+        || hd.cw > WORLD_MAX_SIDE || hd.ch > WORLD_MAX_SIDE || hd.sx < 0 || hd.sy < 0
+        || hd.sx >= (int)hd.cw * WORLD_CHUNK || hd.sy >= (int)hd.ch * WORLD_CHUNK)
+        return (world_error(g, path, "not a poke3d world (bad header)"));
+    w->cw = (int)hd.cw;
+    w->ch = (int)hd.ch;
+    w->ahead = WORLD_AHEAD;
+    w->delay_us = env ? atoi(env) : 0;
+    spread_init();
+    if (!cache_alloc(w) || !window_alloc(&g->grid))
+        panic("malloc world");
+    g->map_w = WORLD_CELLS;
+    g->map_h = WORLD_CELLS;
+    world_first(g, &hd);
+    if (!mip_build(&g->grid, WORLD_CELLS))
+        panic("malloc grid");
+    /* Le champ de distance n'est pas tenu à jour: sauts par la pyramide */
+    if (g->dda_skip == DDA_SKIP_FIELD)
+        g->dda_skip = DDA_SKIP_MIP;
+    pthread_mutex_init(&w->mu, NULL);
+    pthread_cond_init(&w->cv, NULL);
+    if (pthread_create(&w->thread, NULL, world_loader, w) != 0)
+        panic("pthread_create world loader");
+    w->active = true;
+    render_invalidate(g, DIRTY_MAP);
+    return (1);
+}
+
+void    world_close(t_game *g)
+{
+    t_world *w = &g->world;
+
+    if (w->active)
+    {
+        pthread_mutex_lock(&w->mu);
+        w->stop = true;
+        pthread_cond_signal(&w->cv);
+        pthread_mutex_unlock(&w->mu);
+        pthread_join(w->thread, NULL);
+        pthread_mutex_destroy(&w->mu);
+        pthread_cond_destroy(&w->cv);
+    }
+    if (w->fd > 0)
+        close(w->fd);
+    free(w->slots);
+    free(w->bucket);
+    __builtin_memset(w, 0, sizeof(*w));
+}
+
+/* ---- Écriture ----------------------------------------------------------- */
+
+int     world_write(const char *path, const t_spawn *spawn, int cw, int ch,
+                    t_world_gen gen, void *ctx)
+{
+    unsigned long long  rows[WORLD_CHUNK];
+    unsigned long long  *index;
+    unsigned long long  at;
+    unsigned long long  all;
+    unsigned long long  any;
+    t_world_head        hd;
+    int                 fd;
+    int                 k;
+    int                 y;
+
+    __builtin_memset(&hd, 0, sizeof(hd));
+    __builtin_memcpy(hd.magic, WORLD_MAGIC, 8);
+    hd.version = WORLD_VERSION;
+    hd.chunk = WORLD_CHUNK;
+    hd.cw = (unsigned int)cw;
+    hd.ch = (unsigned int)ch;
+    hd.sx = spawn->x;
+    hd.sy = spawn->y;
+    hd.deg = spawn->deg;
+    index = (unsigned long long *)malloc(sizeof(*index) * cw * ch);
+    fd = open(path, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (!index || fd < 0)
+    {
+        free(index);
+        if (fd >= 0)
+            close(fd);
+        return (0);
+    }
+    at = sizeof(hd) + sizeof(*index) * cw * ch;
+    k = 0;
+    while (k < cw * ch)
+    {
+        gen(ctx, k % cw, k / cw, rows);
+        all = ~0ull;
+        any = 0;
+        y = 0;
+        while (y < WORLD_CHUNK)
+        {
+            all &= rows[y];
+            any |= rows[y++];
+        }
+        index[k] = !any ? WORLD_EMPTY : (all == ~0ull) ? WORLD_FULL : at;
+        if (index[k] == at && pwrite(fd, rows, sizeof(rows), (off_t)at) == sizeof(rows))
+            at += sizeof(rows);
+        else if (index[k] == at)
+            break ;
+        k++;
+    }
+    if (k < cw * ch || pwrite(fd, &hd, sizeof(hd), 0) != sizeof(hd)
+        || pwrite(fd, index, sizeof(*index) * cw * ch, sizeof(hd))
+           != (ssize_t)(sizeof(*index) * cw * ch))
+        k = -1;
+    free(index);
+    return (close(fd) == 0 && k == cw * ch);
+}
+
+/* Chunk (cx, cy) de la carte chargée (hors carte: plein, voir is_wall) */
+static void world_from_map(void *ctx, int cx, int cy, unsigned long long *rows)
+{
+    const t_game    *g = (const t_game *)ctx;
+    int             x;
+    int             y;
+
+    y = 0;
+    while (y < WORLD_CHUNK)
+    {
+        rows[y] = 0;
+        x = 0;
+        while (x < WORLD_CHUNK)
+        {
+            if (is_wall(g, cx * WORLD_CHUNK + x, cy * WORLD_CHUNK + y))
+                rows[y] |= 1ull << x;
+            x++;
+        }
+        y++;
+    }
+}
+
+int     world_save(t_game *g, const char *path)
+{
+    t_spawn sp;
+
+    sp.x = (int)g->p.pos.x;
+    sp.y = (int)g->p.pos.y;
+    sp.deg = atan2f(g->p.dir.y, g->p.dir.x) * 180.0f / (float)M_PI;
+    if (g->spawn_count > 0)
+        sp = g->spawns[0];
+    return (world_write(path, &sp, (g->map_w + WORLD_CHUNK - 1) / WORLD_CHUNK,
+                        (g->map_h + WORLD_CHUNK - 1) / WORLD_CHUNK, world_from_map, g));
+}
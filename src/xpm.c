@@ -0,0 +1,203 @@
+#include "game.h"
+#include <stdio.h>    /* fopen(), fread() */
+
+/* ==========================================================================
+**  Lecteur XPM autonome (backend sans X)
+**  --------------------------------------------------------------------------
+**  mlx_xpm_file_to_image a besoin d'une connexion X. Le backend mémoire lit
+**  donc les XPM lui-même: en-tête "w h ncolors cpp", table de couleurs
+**  ("cc c #RRGGBB" ou "None"), puis h lignes de w pixels. Les clés de
+**  couleur (cpp <= XPM_MAX_CPP caractères imprimables) indexent une table
+**  directe, sans recherche. Sortie: pixels 32 bits 0x00RRGGBB, "None" en
+**  0xFF000000 comme MiniLibX.
+**
+**  xpm_load : charge path dans t (addr/w/h/bpp/line_len; t->img reste NULL)
+** ========================================================================== */
+
+/* Contenu du fichier entier, terminé par '\0' */
+static char *slurp(const char *path)
+{
+    FILE    *f;
+    char    *buf;
+    long    n;
+
+    f = fopen(path, "rb");
+    if (!f)
+        return (NULL);
+    buf = NULL;
+    if (fseek(f, 0, SEEK_END) == 0 && (n = ftell(f)) > 0
+        && fseek(f, 0, SEEK_SET) == 0)
+    {
+        buf = (char *)malloc(n + 1);
+        if (buf && fread(buf, 1, n, f) != (size_t)n)
+        {
+            free(buf);
+            buf = NULL;
+        }
+        if (buf)
+            buf[n] = '\0';
+    }
+    fclose(f);
+    return (buf);
+}
+
+/* Chaîne C suivante ("...") à partir de *p; renvoie son début, *len sa taille */
+static const char   *next_str(const char **p, int *len)
+{
+    const char  *s;
+    const char  *e;
+
+    s = strchr(*p, '"');
+    if (!s)
+        return (NULL);
+    e = strchr(s + 1, '"');
+    if (!e)
+        return (NULL);
+    *p = e + 1;
+    *len = (int)(e - s - 1);
+    return (s + 1);
+}
+
+static int  key_of(const char *s, int cpp)
+{
+    int k;
+    int i;
+
+    k = 0;
+    i = 0;
+    while (i < cpp)
+    {
+        if ((unsigned char)s[i] < 32 || (unsigned char)s[i] > 126)
+            return (-1);
+        k = k * 95 + (s[i] - 32);
+        i++;
+    }
+    return (k);
+}
+
+static int  hex_digit(char c)
+{
+    if (c >= '0' && c <= '9') return (c - '0');
+    if (c >= 'a' && c <= 'f') return (c - 'a' + 10);
+    if (c >= 'A' && c <= 'F') return (c - 'A' + 10);
+    return (-1);
+}
+
+/* "c #RRGGBB" / "c None" dans la définition d'une couleur */
+static int  parse_color(const char *s, int len, unsigned int *out)
+{
+    unsigned int    c;
+    int             d;
+    int             i;
+    int             n;
+
+    i = 0;
+    while (i + 1 < len && !(s[i] == 'c' && (s[i + 1] == ' ' || s[i + 1] == '\t')))
+        i++;
+    i += 2;
+    while (i < len && (s[i] == ' ' || s[i] == '\t'))
+        i++;
+    if (i + 4 <= len && !strncmp(s + i, "None", 4))
+    {
+        *out = 0xFF000000u;
+        return (1);
+    }
+    if (i + 7 > len || s[i] != '#')
+        return (0);
+    c = 0;
+    n = 1;
+    while (n <= 6)
+    {
+        d = hex_digit(s[i + n++]);
+        if (d < 0)
+            return (0);
+        c = (c << 4) | (unsigned int)d;
+    }
+    *out = c;
+    return (1);
+}
+
+/* Table de couleurs puis pixels, à la suite de l'en-tête */
+static int  xpm_body(t_tex *t, const char *p, unsigned int *lut, int ncol, int cpp)
+{
+    const char  *s;
+    int         len;
+    int         i;
+    int         x;
+    int         k;
+
+    i = 0;
+    while (i < ncol)
+    {
+        s = next_str(&p, &len);
+        if (!s || len < cpp || (k = key_of(s, cpp)) < 0
+            || !parse_color(s + cpp, len - cpp, &lut[k]))
+            return (0);
+        i++;
+    }
+    i = 0;
+    while (i < t->h)
+    {
+        s = next_str(&p, &len);
+        if (!s || len < t->w * cpp)
+            return (0);
+        x = 0;
+        while (x < t->w)
+        {
+            k = key_of(s + x * cpp, cpp);
+            ((unsigned int *)t->addr)[i * t->w + x] = (k < 0) ? 0 : lut[k];
+            x++;
+        }
+        i++;
+    }
+    return (1);
+}
+
+static int  xpm_parse(t_tex *t, const char *p)
+{
+    const char      *s;
+    unsigned int    *lut;
+    int             len;
+    int             ncol;
+    int             cpp;
+    int             nkeys;
+    int             ok;
+
+    s = next_str(&p, &len);
+    if (!s || sscanf(s, "%d %d %d %d", &t->w, &t->h, &ncol, &cpp) != 4
+        || t->w <= 0 || t->h <= 0 || ncol <= 0 || cpp < 1 || cpp > XPM_MAX_CPP)
+        return (0);
+    nkeys = 1;
+    len = 0;
+    while (len++ < cpp)
+        nkeys *= 95;
+    t->addr = (char *)malloc(sizeof(unsigned int) * t->w * t->h);
+    lut = (unsigned int *)calloc(nkeys, sizeof(unsigned int));
+    ok = (t->addr && lut && xpm_body(t, p, lut, ncol, cpp));
+    free(lut);
+    return (ok);
+}
+
+int     xpm_load(t_tex *t, const char *path)
+{
+    char    *buf;
+    int     ok;
+
+    buf = slurp(path);
+    if (!buf)
+        return (0);
+    t->img = NULL;
+    t->addr = NULL;
+    ok = xpm_parse(t, buf);
+    free(buf);
+    if (!ok)
+    {
+        free(t->addr);
+        t->addr = NULL;
+        return (0);
+    }
+    t->bpp = 32;
+    t->line_len = t->w * 4;
+    t->endian = 0;
+    return (1);
+}